@@ -0,0 +1,83 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "chainedIndex.h"
+#include "wordList.h"
+
+// Smallest number of slots in a chained index
+#define MIN_INDEX_SIZE 16
+
+/*
+ * Finds the slot of a key in a chained index with size slots.
+ * Returns the slot holding the first dictionary word with the key, or the
+ * empty slot where it would be inserted.
+ */
+unsigned int find_chain_slot(const void *key, unsigned int hash,
+        KeyMatch matches, const int *slots, unsigned int size,
+        WordList *dictList) {
+    unsigned int slot = hash & (size - 1);
+
+    for (int found = slots[slot]; found != -1; found = slots[slot]) {
+        if (matches(dictList, found, key, hash)) {
+            break;
+        }
+        slot = (slot + 1) & (size - 1);
+    }
+
+    return slot;
+}
+
+/*
+ * Builds an index of the words in a dictionary read by file_to_wordlist,
+ * keyed by word_key.
+ *
+ * Each distinct key has one slot, found by linear probing in a table kept
+ * at most half full. Words sharing a key are chained from that slot in
+ * dictionary order through next (-1 ends a chain).
+ * The table and its number of slots are stored at slots and size.
+ */
+void build_chained_index(WordList *dictList, WordKey word_key,
+        KeyMatch matches, int **slots, unsigned int *size, int **next) {
+    WordMeta *meta = dictList->meta;
+
+    // Count all-letter words (the most that can be indexed) from the stats
+    int numAlpha = 0;
+    for (int length = 0; length <= meta->maxLength; ++length) {
+        numAlpha += meta->lengthCounts[length];
+    }
+
+    unsigned int tableSize = MIN_INDEX_SIZE;
+    while (tableSize < 2 * (unsigned int) numAlpha) {
+        tableSize *= 2;
+    }
+
+    // Every byte of -1 is still -1, marking every slot as empty
+    int *table = malloc(tableSize * sizeof(int));
+    memset(table, -1, tableSize * sizeof(int));
+    int *chains = malloc(dictList->numWords * sizeof(int));
+    memset(chains, -1, dictList->numWords * sizeof(int));
+    // Last word in the chain of each slot, so words are added in order
+    int *last = malloc(tableSize * sizeof(int));
+
+    for (int word = 0; word < dictList->numWords; ++word) {
+        unsigned int hash;
+        const void *key = word_key(dictList, word, &hash);
+        if (key == NULL) {
+            continue;
+        }
+
+        unsigned int slot = find_chain_slot(key, hash, matches, table,
+                tableSize, dictList);
+        if (table[slot] == -1) {
+            table[slot] = word;
+        } else {
+            chains[last[slot]] = word;
+        }
+        last[slot] = word;
+    }
+    free(last);
+
+    *slots = table;
+    *size = tableSize;
+    *next = chains;
+}
@@ -0,0 +1,27 @@
+#ifndef CHAINEDINDEX_H
+#define CHAINEDINDEX_H
+
+#include <stdbool.h>
+#include "wordList.h"
+
+/*
+ * Returns the key a dictionary word is indexed by and stores the key's hash
+ * at hash, or returns NULL if the word isn't indexed.
+ * Only all-letter words can be indexed.
+ */
+typedef const void *(*WordKey)(WordList *dictList, int word,
+        unsigned int *hash);
+
+/*
+ * Checks if a dictionary word has the given key (whose hash is hash)
+ */
+typedef bool (*KeyMatch)(WordList *dictList, int word, const void *key,
+        unsigned int hash);
+
+unsigned int find_chain_slot(const void *key, unsigned int hash,
+        KeyMatch matches, const int *slots, unsigned int size,
+        WordList *dictList);
+void build_chained_index(WordList *dictList, WordKey word_key,
+        KeyMatch matches, int **slots, unsigned int *size, int **next);
+
+#endif //CHAINEDINDEX_H
@@ -0,0 +1,426 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include "libsearch.h"
+#include "wordList.h"
+#include "readDict.h"
+#include "wordIndex.h"
+#include "signatureIndex.h"
+#include "searchMethods.h"
+#include "patternDfa.h"
+#include "queryPlan.h"
+
+/*
+ * A dictionary read by search_dict_open.
+ * dictList: the dictionary's words and metadata
+ * indexLock: held while queries are planned and while the hash and
+ *            signature indexes are built, as they are only built once a
+ *            lookup or anagram search needs them
+ * wordIndexBuilt: set (with release ordering) once the hash index is
+ *                 built, so lookups can check it without taking indexLock
+ */
+struct SearchDict {
+    WordList *dictList;
+    pthread_mutex_t indexLock;
+    bool wordIndexBuilt;
+};
+
+/*
+ * A pattern and search mode compiled by search_query_compile.
+ * pattern: copy of the pattern
+ * mode: search mode (EXACT, PREFIX, ANYWHERE, ANAGRAM or SUBANAGRAM)
+ * flags: SEARCH_ flags the query was compiled with
+ * dfa: the compiled pattern if it uses extended syntax, else NULL
+ */
+struct SearchQuery {
+    char *pattern;
+    int mode;
+    int flags;
+    PatternDfa *dfa;
+};
+
+/*
+ * Where search_query_collect stores results, passed to collect_word
+ */
+typedef struct {
+    const char **results;
+    size_t capacity;
+    size_t numResults;
+} Collection;
+
+/*
+ * Reads the dictionary file at path into a new SearchDict stored at dict.
+ * Returns SEARCH_OK, SEARCH_ERR_OPEN if the file can't be opened,
+ * SEARCH_ERR_READ if it can't be read (e.g. it is a directory) or
+ * SEARCH_ERR_MEMORY if it doesn't fit in memory.
+ */
+int search_dict_open(const char *path, SearchDict **dict) {
+    if (path == NULL || dict == NULL) {
+        return SEARCH_ERR_ARGS;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return SEARCH_ERR_OPEN;
+    }
+
+    SearchDict *result = malloc(sizeof(SearchDict));
+    if (result == NULL) {
+        fclose(file);
+        return SEARCH_ERR_MEMORY;
+    }
+
+    // A read error is left set on the file, else memory ran out
+    result->dictList = file_to_wordlist(file);
+    int status = SEARCH_OK;
+    if (result->dictList == NULL) {
+        status = ferror(file) ? SEARCH_ERR_READ : SEARCH_ERR_MEMORY;
+    }
+    fclose(file);
+    if (status != SEARCH_OK) {
+        free(result);
+        return status;
+    }
+    pthread_mutex_init(&result->indexLock, NULL);
+    result->wordIndexBuilt = false;
+
+    *dict = result;
+    return SEARCH_OK;
+}
+
+/*
+ * Frees memory allocated to a SearchDict, including the words given to
+ * callbacks and stored by search_query_collect
+ */
+void search_dict_close(SearchDict *dict) {
+    if (dict == NULL) {
+        return;
+    }
+
+    pthread_mutex_destroy(&dict->indexLock);
+    free_wordlist(dict->dictList);
+    free(dict);
+}
+
+/*
+ * Builds a dictionary's hash index if it hasn't been built yet.
+ * Only the first callers take indexLock, once wordIndexBuilt is seen set
+ * the index is complete and can be read without it.
+ */
+static void ensure_word_index(SearchDict *dict) {
+    if (__atomic_load_n(&dict->wordIndexBuilt, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    pthread_mutex_lock(&dict->indexLock);
+    build_word_index(dict->dictList);
+    __atomic_store_n(&dict->wordIndexBuilt, true, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&dict->indexLock);
+}
+
+/*
+ * Checks if a word is in a dictionary, ignoring case.
+ * Words containing non-letters are never found.
+ */
+bool search_dict_contains(SearchDict *dict, const char *word) {
+    if (dict == NULL || word == NULL) {
+        return false;
+    }
+
+    // The hash index is built by the first lookup
+    ensure_word_index(dict);
+
+    return index_contains(word, dict->dictList);
+}
+
+/*
+ * Checks if a pattern is valid for a search mode: letters and question
+ * marks only, or also '*' and classes if extended
+ */
+static bool check_pattern(const char *pattern, bool extended) {
+    if (extended) {
+        return check_extended_pattern((char *) pattern);
+    }
+
+    // Check if each character in the pattern is a letter or ?
+    for (int i = 0; pattern[i] != '\0'; ++i) {
+        if (!isalpha((unsigned char) pattern[i]) && pattern[i] != '?') {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Compiles a pattern for a search mode (SEARCH_EXACT etc.) and flags into a
+ * new SearchQuery stored at query.
+ * SEARCH_EXTENDED is only allowed for exact, prefix and anywhere searches.
+ * Returns SEARCH_OK, SEARCH_ERR_ARGS for an invalid mode or flags,
+ * SEARCH_ERR_PATTERN for an invalid pattern or SEARCH_ERR_MEMORY.
+ */
+int search_query_compile(const char *pattern, int mode, int flags,
+        SearchQuery **query) {
+    bool extended = flags & SEARCH_EXTENDED;
+
+    if (pattern == NULL || query == NULL || mode < SEARCH_EXACT
+            || mode > SEARCH_SUBANAGRAM
+            || (flags & ~(SEARCH_SORT | SEARCH_EXTENDED | SEARCH_ONCE))
+            || (extended && mode > SEARCH_ANYWHERE)) {
+        return SEARCH_ERR_ARGS;
+    }
+    if (!check_pattern(pattern, extended)) {
+        return SEARCH_ERR_PATTERN;
+    }
+
+    SearchQuery *result = malloc(sizeof(SearchQuery));
+    if (result == NULL) {
+        return SEARCH_ERR_MEMORY;
+    }
+    result->pattern = calloc(strlen(pattern) + 1, sizeof(char));
+    if (result->pattern == NULL) {
+        free(result);
+        return SEARCH_ERR_MEMORY;
+    }
+    strcpy(result->pattern, pattern);
+    result->mode = mode;
+    result->flags = flags;
+    result->dfa = NULL;
+    if (extended && is_extended_pattern(result->pattern)) {
+        result->dfa = compile_pattern(result->pattern, mode);
+        if (result->dfa == NULL) {
+            free(result->pattern);
+            free(result);
+            return SEARCH_ERR_MEMORY;
+        }
+    }
+
+    *query = result;
+    return SEARCH_OK;
+}
+
+/*
+ * Frees memory allocated to a SearchQuery
+ */
+void search_query_free(SearchQuery *query) {
+    if (query == NULL) {
+        return;
+    }
+
+    if (query->dfa != NULL) {
+        free_dfa(query->dfa);
+    }
+    free(query->pattern);
+    free(query);
+}
+
+/*
+ * Plans a query against a dictionary. Exact queries of only letters are
+ * looked up in the hash index, which is built for them first unless the
+ * query is only run once (SEARCH_ONCE).
+ * The plan depends on which indexes exist, so planning holds indexLock.
+ */
+static QueryPlan plan_search(const SearchQuery *query, SearchDict *dict) {
+    if (query->mode == SEARCH_EXACT && query->dfa == NULL
+            && !(query->flags & SEARCH_ONCE) && query->pattern[0] != '\0'
+            && strchr(query->pattern, '?') == NULL) {
+        ensure_word_index(dict);
+    }
+
+    pthread_mutex_lock(&dict->indexLock);
+    QueryPlan plan = plan_query(query->mode, query->pattern, query->dfa,
+            dict->dictList);
+    pthread_mutex_unlock(&dict->indexLock);
+
+    return plan;
+}
+
+/*
+ * Gathers the dictionary words equal to a pattern of only letters into
+ * matches, without copying them, by following their chain in the hash
+ * index. No other words are visited.
+ * Returns SEARCH_OK or SEARCH_ERR_MEMORY.
+ */
+static int gather_indexed(const char *pattern, WordList *dictList,
+        WordList *matches) {
+    int first = index_lookup(pattern, dictList);
+    int *next = dictList->meta->indexNext;
+
+    matches->numWords = 0;
+    for (int word = first; word != -1; word = next[word]) {
+        matches->numWords++;
+    }
+    matches->words = (char **) malloc(matches->numWords * sizeof(char *));
+    if (matches->words == NULL && matches->numWords > 0) {
+        return SEARCH_ERR_MEMORY;
+    }
+    for (int word = first, i = 0; word != -1; word = next[word]) {
+        matches->words[i++] = dictList->words[word];
+    }
+
+    return SEARCH_OK;
+}
+
+/*
+ * Runs a planned query against a dictionary and gathers the matching words
+ * into matches, without copying them. The dictionary's signature index is
+ * built first if the plan needs it.
+ * Returns SEARCH_OK or SEARCH_ERR_MEMORY.
+ */
+static int gather_scanned(QueryPlan *plan, SearchDict *dict,
+        WordList *matches) {
+    WordList *dictList = dict->dictList;
+
+    if (plan->engine == PLAN_SIGNATURE || plan->engine == PLAN_LETTER_COUNT) {
+        pthread_mutex_lock(&dict->indexLock);
+        build_signature_index(dictList);
+        pthread_mutex_unlock(&dict->indexLock);
+    }
+    bool *wordFlags = run_plan(plan, dictList);
+    if (wordFlags == NULL) {
+        return SEARCH_ERR_MEMORY;
+    }
+
+    matches->numWords = 0;
+    for (int word = 0; word < dictList->numWords; ++word) {
+        matches->numWords += wordFlags[word];
+    }
+    matches->words = (char **) malloc(matches->numWords * sizeof(char *));
+    if (matches->words == NULL && matches->numWords > 0) {
+        free(wordFlags);
+        return SEARCH_ERR_MEMORY;
+    }
+    for (int word = 0, i = 0; i < matches->numWords; ++word) {
+        if (wordFlags[word]) {
+            matches->words[i++] = dictList->words[word];
+        }
+    }
+    free(wordFlags);
+
+    return SEARCH_OK;
+}
+
+/*
+ * Runs a query against a dictionary, calling callback with each matching
+ * word and data until it returns non-zero.
+ * Returns SEARCH_OK, SEARCH_ERR_ARGS if any argument is NULL or
+ * SEARCH_ERR_MEMORY.
+ */
+int search_query_run(const SearchQuery *query, SearchDict *dict,
+        SearchCallback callback, void *data) {
+    if (query == NULL || dict == NULL || callback == NULL) {
+        return SEARCH_ERR_ARGS;
+    }
+
+    /*
+     * Gather the matching words, without copying them, so they can be
+     * sorted if required
+     */
+    QueryPlan plan = plan_search(query, dict);
+    WordList matches;
+    matches.meta = NULL;
+    int status = plan.engine == PLAN_HASH
+            ? gather_indexed(query->pattern, dict->dictList, &matches)
+            : gather_scanned(&plan, dict, &matches);
+    if (status != SEARCH_OK) {
+        return status;
+    }
+
+    if (query->flags & SEARCH_SORT) {
+        sort_wordlist(&matches);
+    }
+
+    for (int i = 0; i < matches.numWords; ++i) {
+        if (callback(matches.words[i], data)) {
+            break;
+        }
+    }
+
+    // Only the array is freed, the words belong to the dictionary
+    free(matches.words);
+    return SEARCH_OK;
+}
+
+/*
+ * Callback for search_query_collect, stores a word in a Collection if
+ * there is room and counts it either way
+ */
+static int collect_word(const char *word, void *data) {
+    Collection *collection = (Collection *) data;
+
+    if (collection->numResults < collection->capacity) {
+        collection->results[collection->numResults] = word;
+    }
+    collection->numResults++;
+
+    return 0;
+}
+
+/*
+ * Runs a query against a dictionary, storing up to capacity matching words
+ * in results. The total number of matches is stored at numResults.
+ * The words belong to the dictionary handle.
+ * Returns SEARCH_OK, or SEARCH_ERR_BUFFER if not every match fit in
+ * results.
+ */
+int search_query_collect(const SearchQuery *query, SearchDict *dict,
+        const char **results, size_t capacity, size_t *numResults) {
+    if (numResults == NULL || (results == NULL && capacity > 0)) {
+        return SEARCH_ERR_ARGS;
+    }
+
+    Collection collection;
+    collection.results = results;
+    collection.capacity = capacity;
+    collection.numResults = 0;
+
+    int status = search_query_run(query, dict, collect_word, &collection);
+    if (status != SEARCH_OK) {
+        return status;
+    }
+
+    *numResults = collection.numResults;
+    return collection.numResults > capacity ? SEARCH_ERR_BUFFER : SEARCH_OK;
+}
+
+/*
+ * Prints how a query would be run against a dictionary (see explain_plan)
+ */
+int search_query_explain(const SearchQuery *query, SearchDict *dict,
+        FILE *out) {
+    if (query == NULL || dict == NULL || out == NULL) {
+        return SEARCH_ERR_ARGS;
+    }
+
+    QueryPlan plan = plan_search(query, dict);
+    explain_plan(out, &plan, dict->dictList);
+
+    return SEARCH_OK;
+}
+
+/*
+ * Returns a description of a status code
+ */
+const char *search_strerror(int status) {
+    switch (status) {
+        case SEARCH_OK:
+            return "success";
+        case SEARCH_ERR_ARGS:
+            return "invalid arguments";
+        case SEARCH_ERR_OPEN:
+            return "dictionary can not be opened";
+        case SEARCH_ERR_PATTERN:
+            return "invalid pattern";
+        case SEARCH_ERR_BUFFER:
+            return "results buffer too small";
+        case SEARCH_ERR_READ:
+            return "dictionary can not be read";
+        case SEARCH_ERR_MEMORY:
+            return "out of memory";
+        default:
+            return "unknown error";
+    }
+}
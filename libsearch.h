@@ -0,0 +1,91 @@
+#ifndef LIBSEARCH_H
+#define LIBSEARCH_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * libsearch: the dictionary search behind the search command, for use
+ * in-process.
+ *
+ * A dictionary is read once into a SearchDict handle, and a pattern and
+ * search mode are compiled once into a SearchQuery. A query can then be run
+ * any number of times, against any dictionary.
+ *
+ * Any number of threads may use the same handles and queries at once. Only
+ * opening, closing, compiling and freeing must not overlap with other use of
+ * the same handle or query.
+ *
+ * Queries are never changed by running them, but a handle builds two
+ * indexes the first time they are needed: the hash index on the first
+ * search_dict_contains or exact query (unless SEARCH_ONCE), and the
+ * letter-count index on the first anagram or subanagram query. That call
+ * pays for the build, and holds a lock on the handle meanwhile. Other calls
+ * on the handle wait for that lock while their queries are planned.
+ *
+ * Every function that can fail returns one of the status codes below.
+ * SEARCH_ERR_MEMORY is returned when there isn't memory for the dictionary,
+ * a compiled pattern or a query's results. Building the two indexes above
+ * assumes their allocations succeed.
+ */
+
+// Status codes
+#define SEARCH_OK 0
+#define SEARCH_ERR_ARGS 1
+#define SEARCH_ERR_OPEN 2
+#define SEARCH_ERR_PATTERN 3
+#define SEARCH_ERR_BUFFER 4
+#define SEARCH_ERR_READ 5
+#define SEARCH_ERR_MEMORY 6
+
+// Search modes
+#define SEARCH_EXACT 0
+#define SEARCH_PREFIX 1
+#define SEARCH_ANYWHERE 2
+#define SEARCH_ANAGRAM 3
+#define SEARCH_SUBANAGRAM 4
+
+// Query flags, combined with |
+#define SEARCH_SORT 1
+#define SEARCH_EXTENDED 2
+/*
+ * The query will only be run once, so an exact query scans the dictionary
+ * rather than building its hash index (which costs more than one scan)
+ */
+#define SEARCH_ONCE 4
+
+/*
+ * Marks the functions exported by libsearch.so. The library is built with
+ * hidden visibility, so nothing else in it can clash with the caller's names.
+ */
+#define SEARCH_API __attribute__((visibility("default")))
+
+typedef struct SearchDict SearchDict;
+typedef struct SearchQuery SearchQuery;
+
+/*
+ * Called with each matching word, in dictionary order (or alphabetical
+ * order with SEARCH_SORT). The word belongs to the dictionary handle.
+ * Return 0 to continue, anything else to stop the search.
+ */
+typedef int (*SearchCallback)(const char *word, void *data);
+
+SEARCH_API int search_dict_open(const char *path, SearchDict **dict);
+SEARCH_API void search_dict_close(SearchDict *dict);
+SEARCH_API bool search_dict_contains(SearchDict *dict, const char *word);
+
+SEARCH_API int search_query_compile(const char *pattern, int mode, int flags,
+        SearchQuery **query);
+SEARCH_API void search_query_free(SearchQuery *query);
+
+SEARCH_API int search_query_run(const SearchQuery *query, SearchDict *dict,
+        SearchCallback callback, void *data);
+SEARCH_API int search_query_collect(const SearchQuery *query, SearchDict *dict,
+        const char **results, size_t capacity, size_t *numResults);
+SEARCH_API int search_query_explain(const SearchQuery *query, SearchDict *dict,
+        FILE *out);
+
+SEARCH_API const char *search_strerror(int status);
+
+#endif //LIBSEARCH_H
@@ -0,0 +1,337 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <limits.h>
+#include "patternDfa.h"
+#include "searchMethods.h"
+#include "wordList.h"
+
+// Largest DFA built before falling back to simulating the NFA
+#define DFA_MAX_STATES 1024
+#define DEAD_STATE 0
+#define START_STATE 1
+
+// Letter set of '?' and '*', i.e. every letter
+#define ALL_LETTERS ((1u << DFA_ALPHABET) - 1)
+
+// Bits in each word of an NFA state set
+#define SET_BITS (sizeof(unsigned long) * CHAR_BIT)
+
+/*
+ * Returns the DFA column of a letter, ignoring case
+ */
+static int letter_column(char letter) {
+    return tolower((unsigned char) letter) - 'a';
+}
+
+/*
+ * Reads a character class starting at the '[' at pattern[*index].
+ * *index is moved to the closing ']'.
+ * Returns the letters in the class (one bit per letter), or 0 if the class
+ * is empty, unclosed or contains anything other than letters.
+ */
+static unsigned int parse_class(char *pattern, int *index) {
+    unsigned int letters = 0;
+    bool negated = pattern[*index + 1] == '^';
+    int i = *index + (negated ? 2 : 1);
+
+    for (; pattern[i] != ']'; ++i) {
+        if (!isalpha((unsigned char) pattern[i])) {
+            return 0;
+        }
+        letters |= 1u << letter_column(pattern[i]);
+    }
+
+    *index = i;
+    if (letters == 0) {
+        return 0;
+    }
+    return negated ? ALL_LETTERS & ~letters : letters;
+}
+
+/*
+ * Splits an extended pattern into its elements: letters, '?' and classes
+ * each match one letter, '*' matches any run of letters.
+ * The letters matched by each element are stored in letterSets and the
+ * positions of '*'s in stars (see PatternDfa), unless they are NULL.
+ * Returns the number of non-'*' elements, or -1 if the pattern is invalid.
+ */
+static int parse_pattern(char *pattern, unsigned int *letterSets,
+        bool *stars) {
+    int numElements = 0;
+
+    for (int i = 0; pattern[i] != '\0'; ++i) {
+        unsigned int letters;
+
+        if (pattern[i] == '*') {
+            if (stars != NULL) {
+                stars[numElements] = true;
+            }
+            continue;
+        } else if (pattern[i] == '?') {
+            letters = ALL_LETTERS;
+        } else if (pattern[i] == '[') {
+            letters = parse_class(pattern, &i);
+        } else if (isalpha((unsigned char) pattern[i])) {
+            letters = 1u << letter_column(pattern[i]);
+        } else {
+            letters = 0;
+        }
+
+        // A letter set is only empty for invalid characters and classes
+        if (letters == 0) {
+            return -1;
+        }
+        if (letterSets != NULL) {
+            letterSets[numElements] = letters;
+        }
+        numElements++;
+    }
+
+    return numElements;
+}
+
+/*
+ * Checks if a pattern uses any extended syntax ('*' or a class)
+ */
+bool is_extended_pattern(char *pattern) {
+    return strpbrk(pattern, "*[") != NULL;
+}
+
+/*
+ * Checks if an extended pattern is valid: only letters, '?', '*' and
+ * classes of letters such as [abc] or [^abc]
+ */
+bool check_extended_pattern(char *pattern) {
+    return parse_pattern(pattern, NULL, NULL) != -1;
+}
+
+/*
+ * Moves an NFA state set (setWords unsigned longs) over a letter.
+ * from and to must not overlap.
+ */
+static void step_set(PatternDfa *dfa, int setWords, const unsigned long *from,
+        int column, unsigned long *to) {
+    memset(to, 0, setWords * sizeof(unsigned long));
+
+    for (int state = 0; state <= dfa->numElements; ++state) {
+        if (!(from[state / SET_BITS] & (1ul << (state % SET_BITS)))) {
+            continue;
+        }
+        // Move to the next state if the letter matches this element
+        if (state < dfa->numElements
+                && (dfa->letterSets[state] & (1u << column))) {
+            to[(state + 1) / SET_BITS] |= 1ul << ((state + 1) % SET_BITS);
+        }
+        // Stay in this state if it is followed by a '*'
+        if (dfa->stars[state]) {
+            to[state / SET_BITS] |= 1ul << (state % SET_BITS);
+        }
+    }
+}
+
+/*
+ * Checks if an NFA state set includes the accepting state
+ */
+static bool set_accepts(PatternDfa *dfa, const unsigned long *set) {
+    return set[dfa->numElements / SET_BITS]
+            & (1ul << (dfa->numElements % SET_BITS));
+}
+
+/*
+ * Builds the DFA transition table of a PatternDfa from its NFA by subset
+ * construction. If more than DFA_MAX_STATES states are needed, or the table
+ * can't be allocated, the table is discarded and numStates set to 0.
+ */
+static void build_transitions(PatternDfa *dfa) {
+    int setWords = dfa->numElements / SET_BITS + 1;
+    // NFA state set of each DFA state, setWords per state
+    unsigned long *stateSets = calloc((size_t) DFA_MAX_STATES * setWords,
+            sizeof(unsigned long));
+    unsigned long *next = malloc(setWords * sizeof(unsigned long));
+    dfa->transitions = calloc((size_t) DFA_MAX_STATES * DFA_ALPHABET,
+            sizeof(int));
+    dfa->accepting = calloc(DFA_MAX_STATES, sizeof(bool));
+    dfa->numStates = 0;
+
+    // Without memory for the table the NFA is simulated instead
+    if (stateSets == NULL || next == NULL || dfa->transitions == NULL
+            || dfa->accepting == NULL) {
+        free(dfa->transitions);
+        free(dfa->accepting);
+        dfa->transitions = NULL;
+        dfa->accepting = NULL;
+        free(stateSets);
+        free(next);
+        return;
+    }
+
+    // The dead state has an empty set, the start state is just NFA state 0
+    stateSets[START_STATE * setWords] = 1;
+    dfa->accepting[START_STATE] = set_accepts(dfa,
+            &stateSets[START_STATE * setWords]);
+    dfa->numStates = 2;
+
+    // States are processed in the order they are found
+    for (int state = START_STATE; state < dfa->numStates; ++state) {
+        for (int column = 0; column < DFA_ALPHABET; ++column) {
+            step_set(dfa, setWords, &stateSets[state * setWords], column,
+                    next);
+
+            // Find the DFA state with this set, adding it if it is new
+            int found = 0;
+            while (found < dfa->numStates && memcmp(&stateSets[found
+                    * setWords], next, setWords * sizeof(unsigned long))) {
+                found++;
+            }
+            if (found == dfa->numStates) {
+                if (dfa->numStates == DFA_MAX_STATES) {
+                    // Too many states, the NFA will be simulated instead
+                    free(dfa->transitions);
+                    free(dfa->accepting);
+                    dfa->transitions = NULL;
+                    dfa->accepting = NULL;
+                    dfa->numStates = 0;
+                    free(stateSets);
+                    free(next);
+                    return;
+                }
+                memcpy(&stateSets[found * setWords], next,
+                        setWords * sizeof(unsigned long));
+                dfa->accepting[found] = set_accepts(dfa, next);
+                dfa->numStates++;
+            }
+
+            dfa->transitions[state * DFA_ALPHABET + column] = found;
+        }
+    }
+
+    free(stateSets);
+    free(next);
+}
+
+/*
+ * Compiles an extended pattern for a search mode (EXACT, PREFIX or
+ * ANYWHERE) to a PatternDfa. Prefix patterns are compiled as if they ended
+ * in '*' and anywhere patterns as if they started and ended in '*'.
+ * The pattern must be valid (see check_extended_pattern).
+ * Returns NULL if the PatternDfa can't be allocated.
+ */
+PatternDfa *compile_pattern(char *pattern, int searchOption) {
+    PatternDfa *dfa = malloc(sizeof(PatternDfa));
+    int patternLength = strlen(pattern);
+    if (dfa == NULL) {
+        return NULL;
+    }
+
+    dfa->letterSets = malloc((patternLength + 1) * sizeof(unsigned int));
+    dfa->stars = calloc(patternLength + 1, sizeof(bool));
+    if (dfa->letterSets == NULL || dfa->stars == NULL) {
+        free(dfa->letterSets);
+        free(dfa->stars);
+        free(dfa);
+        return NULL;
+    }
+    dfa->numElements = parse_pattern(pattern, dfa->letterSets, dfa->stars);
+
+    if (searchOption == ANYWHERE) {
+        dfa->stars[0] = true;
+    }
+    if (searchOption != EXACT) {
+        dfa->stars[dfa->numElements] = true;
+    }
+
+    // Without any '*', only words of the same length as the NFA can match
+    dfa->minLength = dfa->numElements;
+    dfa->maxLength = dfa->numElements;
+    for (int i = 0; i <= dfa->numElements; ++i) {
+        if (dfa->stars[i]) {
+            dfa->maxLength = INT_MAX;
+        }
+    }
+
+    build_transitions(dfa);
+    return dfa;
+}
+
+/*
+ * Checks if a word of letters is matched by simulating a PatternDfa's NFA,
+ * used when the pattern needs too many states to be a DFA
+ */
+static bool simulate_nfa(PatternDfa *dfa, char *word) {
+    int setWords = dfa->numElements / SET_BITS + 1;
+    unsigned long *current = calloc(setWords, sizeof(unsigned long));
+    unsigned long *next = malloc(setWords * sizeof(unsigned long));
+    bool alive = true;
+
+    current[0] = 1;
+    for (int i = 0; word[i] != '\0' && alive; ++i) {
+        step_set(dfa, setWords, current, letter_column(word[i]), next);
+
+        // Swap the sets and stop once no NFA states are left
+        unsigned long *swap = current;
+        current = next;
+        next = swap;
+        alive = false;
+        for (int j = 0; j < setWords; ++j) {
+            alive = alive || current[j];
+        }
+    }
+
+    bool result = alive && set_accepts(dfa, current);
+    free(current);
+    free(next);
+    return result;
+}
+
+/*
+ * Runs a compiled pattern over every all-letter word in a dictionary with
+ * a length from minLength to the longest the pattern can match.
+ * Each word is run through the DFA's transition table in a single pass.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
+ */
+bool *dfa_match(PatternDfa *dfa, int minLength, WordList *dictList) {
+    bool *wordFlags = (bool *) calloc(dictList->numWords, sizeof(bool));
+    if (wordFlags == NULL) {
+        return NULL;
+    }
+    bool *alphaWords = length_match(minLength, dfa->maxLength, dictList);
+    if (alphaWords == NULL) {
+        free(wordFlags);
+        return NULL;
+    }
+
+    for (int word = 0; word < dictList->numWords; ++word) {
+        if (!alphaWords[word]) {
+            continue;
+        }
+
+        char *currentWord = dictList->words[word];
+        if (dfa->numStates == 0) {
+            wordFlags[word] = simulate_nfa(dfa, currentWord);
+            continue;
+        }
+
+        int state = START_STATE;
+        for (int i = 0; currentWord[i] != '\0' && state != DEAD_STATE; ++i) {
+            state = dfa->transitions[state * DFA_ALPHABET
+                    + letter_column(currentWord[i])];
+        }
+        wordFlags[word] = dfa->accepting[state];
+    }
+
+    free(alphaWords);
+    return wordFlags;
+}
+
+/*
+ * Frees memory allocated to a PatternDfa
+ */
+void free_dfa(PatternDfa *dfa) {
+    free(dfa->letterSets);
+    free(dfa->stars);
+    free(dfa->transitions);
+    free(dfa->accepting);
+    free(dfa);
+}
@@ -0,0 +1,47 @@
+#ifndef PATTERNDFA_H
+#define PATTERNDFA_H
+
+#include <stdbool.h>
+#include "wordList.h"
+
+// Number of letters a DFA has transitions for
+#define DFA_ALPHABET 26
+
+/*
+ * An extended pattern ('*' and [classes] as well as letters and '?')
+ * compiled to a case-insensitive DFA over the letters a-z.
+ *
+ * The pattern is first turned into an NFA with a state for each number of
+ * non-'*' elements matched so far:
+ * numElements: number of non-'*' elements (also the accepting NFA state)
+ * letterSets: letters matched by each element, one bit per letter
+ * stars: stars[i] is true if a '*' follows the first i elements, so NFA
+ *        state i loops on every letter (numElements + 1 entries)
+ *
+ * The DFA made from it by subset construction:
+ * numStates: number of DFA states, 0 if the pattern needed too many (the
+ *            NFA is simulated instead)
+ * transitions: next state for each state and letter, numStates rows of
+ *              DFA_ALPHABET. State 0 is the dead state and 1 the start
+ * accepting: true for each accepting state
+ *
+ * minLength/maxLength: shortest and longest words that could match
+ */
+typedef struct {
+    int numElements;
+    unsigned int *letterSets;
+    bool *stars;
+    int numStates;
+    int *transitions;
+    bool *accepting;
+    int minLength;
+    int maxLength;
+} PatternDfa;
+
+bool is_extended_pattern(char *pattern);
+bool check_extended_pattern(char *pattern);
+PatternDfa *compile_pattern(char *pattern, int searchOption);
+bool *dfa_match(PatternDfa *dfa, int minLength, WordList *dictList);
+void free_dfa(PatternDfa *dfa);
+
+#endif //PATTERNDFA_H
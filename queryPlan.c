@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include "queryPlan.h"
+#include "searchMethods.h"
+#include "wordIndex.h"
+#include "wordList.h"
+#include "patternDfa.h"
+#include "signatureIndex.h"
+
+/*
+ * Names of each engine, indexed by their numbers.
+ * Used for -explain output.
+ */
+static const char *engineNames[] = {"scan", "literal", "length", "no-match",
+        "hash", "dfa", "signature", "letter-count"};
+
+/*
+ * Returns the name of a search mode, used for -explain output
+ */
+static const char *mode_name(int searchOption) {
+    switch (searchOption) {
+        case PREFIX:
+            return "prefix";
+        case ANYWHERE:
+            return "anywhere";
+        case ANAGRAM:
+            return "anagram";
+        case SUBANAGRAM:
+            return "subanagram";
+        default:
+            return "exact";
+    }
+}
+
+/*
+ * Counts the all-letter words in a dictionary with a length from minLength
+ * to maxLength (inclusive), using the statistics gathered when the
+ * dictionary was read.
+ * Returns -1 if the dictionary has no statistics.
+ */
+static int count_candidates(int minLength, int maxLength,
+        WordList *dictList) {
+    if (dictList->meta == NULL) {
+        return -1;
+    }
+
+    int candidates = 0;
+    for (int length = minLength; length <= dictList->meta->maxLength
+            && length <= maxLength; ++length) {
+        candidates += dictList->meta->lengthCounts[length];
+    }
+
+    return candidates;
+}
+
+/*
+ * Counts the question marks in a pattern
+ */
+static int count_wildcards(char *pattern) {
+    int numWildcards = 0;
+
+    for (int i = 0; pattern[i] != '\0'; ++i) {
+        if (pattern[i] == '?') {
+            numWildcards++;
+        }
+    }
+
+    return numWildcards;
+}
+
+/*
+ * Chooses the cheapest way to run a search given the search mode, the
+ * pattern and the dictionary to be searched.
+ * dfa is the pattern compiled by compile_pattern if it uses '*' or
+ * [classes], else NULL. It is not owned by the plan, so can be reused.
+ * The hash index is only used if it has already been built. The caller
+ * decides whether a search is run often enough to be worth building it.
+ * Returns the chosen plan as a QueryPlan struct.
+ */
+QueryPlan plan_query(int searchOption, char *pattern, PatternDfa *dfa,
+        WordList *dictList) {
+    QueryPlan plan;
+    int patternLength = strlen(pattern);
+    int numWildcards = count_wildcards(pattern);
+
+    plan.searchOption = searchOption;
+    plan.pattern = pattern;
+    plan.dfa = dfa;
+
+    /*
+     * Work out which word lengths could match: exact matches and anagrams
+     * must be the same length as the pattern, prefix and anywhere matches
+     * at least as long and subanagrams no longer (anywhere and subanagram
+     * never match an empty word).
+     */
+    plan.minLength = searchOption == SUBANAGRAM ? 1 : patternLength;
+    plan.maxLength = INT_MAX;
+    if (searchOption == EXACT || searchOption == ANAGRAM
+            || searchOption == SUBANAGRAM) {
+        plan.maxLength = patternLength;
+    }
+    if (dfa != NULL) {
+        plan.minLength = plan.dfa->minLength;
+        plan.maxLength = plan.dfa->maxLength;
+    }
+    if (searchOption == ANYWHERE && plan.minLength < 1) {
+        plan.minLength = 1;
+    }
+    plan.candidates = count_candidates(plan.minLength, plan.maxLength,
+            dictList);
+
+    if (plan.candidates == 0) {
+        plan.engine = PLAN_NO_MATCH;
+        plan.reason = "no all-letter word in the dictionary is a length "
+                "that could match";
+    } else if (plan.dfa != NULL) {
+        plan.engine = PLAN_DFA;
+        plan.reason = plan.dfa->numStates > 0
+                ? "pattern uses '*' or [classes], so it is compiled to a "
+                "DFA run once over each word"
+                : "pattern uses '*' or [classes] but needs too many DFA "
+                "states, so its NFA is simulated over each word";
+    } else if (numWildcards == patternLength) {
+        plan.engine = PLAN_LENGTH;
+        plan.reason = "pattern is only question marks, so only word "
+                "lengths are checked";
+    } else if (numWildcards == 0 && searchOption == ANAGRAM) {
+        plan.engine = PLAN_SIGNATURE;
+        plan.reason = "pattern has no blanks, so anagrams are looked up by "
+                "their letter counts";
+    } else if (searchOption == ANAGRAM || searchOption == SUBANAGRAM) {
+        plan.engine = PLAN_LETTER_COUNT;
+        plan.reason = "each word's letter counts are compared with the "
+                "pattern's letters and blanks";
+    } else if (numWildcards == 0 && searchOption == EXACT
+            && dictList->meta != NULL && dictList->meta->indexSlots != NULL) {
+        plan.engine = PLAN_HASH;
+        plan.reason = "pattern has no question marks, so matching words "
+                "are looked up in the hash index";
+    } else if (numWildcards == 0) {
+        plan.engine = PLAN_LITERAL;
+        plan.reason = searchOption == EXACT
+                ? "pattern has no question marks, but the hash index isn't "
+                "built (one scan costs less than building it for a search "
+                "run once), so words are compared as whole strings"
+                : "pattern has no question marks, so words are compared as "
+                "whole strings";
+    } else {
+        plan.engine = PLAN_SCAN;
+        plan.reason = "pattern mixes letters and question marks, so words "
+                "are checked letter by letter";
+    }
+
+    return plan;
+}
+
+/*
+ * Runs a search as planned by plan_query.
+ * Returns a mask (bool arr) of the dictList indices of matching words, or
+ * NULL if the mask can't be allocated.
+ */
+bool *run_plan(QueryPlan *plan, WordList *dictList) {
+    bool *wordFlags;
+
+    switch (plan->engine) {
+        case PLAN_NO_MATCH:
+            wordFlags = (bool *) calloc(dictList->numWords, sizeof(bool));
+            break;
+        case PLAN_LENGTH:
+            wordFlags = length_match(plan->minLength, plan->maxLength,
+                    dictList);
+            break;
+        case PLAN_HASH:
+            wordFlags = index_match(plan->pattern, dictList);
+            break;
+        case PLAN_DFA:
+            wordFlags = dfa_match(plan->dfa, plan->minLength, dictList);
+            break;
+        case PLAN_SIGNATURE:
+            wordFlags = anagram_match(plan->pattern, dictList);
+            break;
+        case PLAN_LETTER_COUNT:
+            wordFlags = letter_count_match(plan->pattern, plan->minLength,
+                    plan->maxLength, dictList);
+            break;
+        case PLAN_LITERAL:
+            wordFlags = literal_match(plan->pattern, plan->searchOption,
+                    dictList);
+            break;
+        default:
+            // Run different search mode depending on given searchOption
+            switch (plan->searchOption) {
+                case PREFIX:
+                    wordFlags = prefix_match(plan->pattern, dictList);
+                    break;
+                case ANYWHERE:
+                    wordFlags = anywhere_match(plan->pattern, dictList);
+                    break;
+                default:
+                    wordFlags = exact_match(plan->pattern, dictList);
+            }
+    }
+
+    return wordFlags;
+}
+
+/*
+ * Prints why and how a search will be run, as planned by plan_query
+ */
+void explain_plan(FILE *out, QueryPlan *plan, WordList *dictList) {
+    fprintf(out, "plan: %s (%s)\n", engineNames[plan->engine],
+            mode_name(plan->searchOption));
+    fprintf(out, "reason: %s\n", plan->reason);
+
+    // Describe the word lengths which could match
+    if (plan->minLength == plan->maxLength) {
+        fprintf(out, "lengths: %d\n", plan->minLength);
+    } else if (plan->maxLength == INT_MAX) {
+        fprintf(out, "lengths: %d or more\n", plan->minLength);
+    } else {
+        fprintf(out, "lengths: %d to %d\n", plan->minLength,
+                plan->maxLength);
+    }
+
+    if (plan->engine == PLAN_DFA && plan->dfa->numStates > 0) {
+        fprintf(out, "dfa states: %d\n", plan->dfa->numStates);
+    }
+
+    if (plan->candidates < 0) {
+        fprintf(out, "candidates: unknown of %d words\n",
+                dictList->numWords);
+    } else {
+        fprintf(out, "candidates: %d of %d words\n", plan->candidates,
+                dictList->numWords);
+    }
+}
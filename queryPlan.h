@@ -0,0 +1,50 @@
+#ifndef QUERYPLAN_H
+#define QUERYPLAN_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "wordList.h"
+#include "patternDfa.h"
+
+/*
+ * Engines a query can be run with, used for the engine member of QueryPlan
+ */
+#define PLAN_SCAN 0
+#define PLAN_LITERAL 1
+#define PLAN_LENGTH 2
+#define PLAN_NO_MATCH 3
+#define PLAN_HASH 4
+#define PLAN_DFA 5
+#define PLAN_SIGNATURE 6
+#define PLAN_LETTER_COUNT 7
+
+/*
+ * How a search will be run, chosen by plan_query from the shape of the
+ * pattern and the dictionary's statistics and index.
+ * engine: PLAN_ engine number
+ * searchOption: search mode (EXACT, PREFIX, ANYWHERE, ANAGRAM or SUBANAGRAM)
+ * pattern: pattern being searched for (not owned by the plan)
+ * minLength/maxLength: lengths of dictionary words which could match
+ * candidates: number of all-letter words with one of those lengths
+ *             (-1 if the dictionary has no statistics)
+ * reason: why the engine was chosen
+ * dfa: compiled pattern if it uses extended syntax, else NULL (not owned
+ *      by the plan)
+ */
+typedef struct {
+    int engine;
+    int searchOption;
+    char *pattern;
+    int minLength;
+    int maxLength;
+    int candidates;
+    const char *reason;
+    PatternDfa *dfa;
+} QueryPlan;
+
+QueryPlan plan_query(int searchOption, char *pattern, PatternDfa *dfa,
+        WordList *dictList);
+bool *run_plan(QueryPlan *plan, WordList *dictList);
+void explain_plan(FILE *out, QueryPlan *plan, WordList *dictList);
+
+#endif //QUERYPLAN_H
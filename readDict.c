@@ -2,111 +2,365 @@
 // Created by wendi on 4/03/2021.
 //
 
+// For memrchr
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
 #include "readDict.h"
 #include "wordList.h"
+#include "wordIndex.h"
+
+// Smallest chunk of the dictionary worth handing to its own thread
+#define MIN_CHUNK_SIZE (256 * 1024)
+// Upper limit on the number of threads used to parse a dictionary
+#define MAX_CHUNKS 64
+// Size of the first read when the size of the dictionary file isn't known
+#define INITIAL_BUFFER_SIZE 4096
 
 /*
- * "Read" in "ReadLine" is past tense :)
- * ReadLine stores lines read from a file with the read_line function.
- * Stores the line read and a bool value representing if the line is the last 
- * line of the file.
+ * A section of the dictionary file parsed by a single thread.
+ * start/end: bounds of the section in the file buffer, every line in a chunk
+ *            is terminated by a '\n'
+ * words/lengths/isAlpha/hashes: words (and their metadata) found in the
+ *                               chunk, in the order they appear in the file
+ * numWords: number of words found in the chunk
+ * lengthCounts/maxLength: number of all-letter words of each length
+ *                         (0 to maxLength) found in the chunk
  */
-
 typedef struct {
-    char *line;
-    bool isLastLine;
-} ReadLine;
+    const char *start;
+    const char *end;
+    char **words;
+    int *lengths;
+    bool *isAlpha;
+    unsigned int *hashes;
+    int numWords;
+    int *lengthCounts;
+    int maxLength;
+} Chunk;
 
 /*
- * Reads a line from a file to a ReadLine
+ * Reads the whole of a file into a buffer.
+ * The number of bytes read is stored at length.
+ * Returns NULL if the file can't be read (e.g. it is a directory) or the
+ * buffer can't be allocated.
  */
-static ReadLine *read_line(FILE *dict) {
+static char *read_file(FILE *dict, size_t *length) {
+    struct stat info;
+    size_t capacity = INITIAL_BUFFER_SIZE;
 
-    int index = 0;
-    char *line = (char *) calloc(1, sizeof(char));
-    int nextChar = fgetc(dict);
-    bool isLastLine = false;
-
-    while ((char) nextChar != '\n') {
-        // Place the last read character into the output string
-        line = (char *) realloc(line, (index + 2) * sizeof(char));
-        line[index] = (char) nextChar;
-     
-        // Read the next character
-        nextChar = fgetc(dict);
-        // Break out of loop if EOF is found
-        if (nextChar == EOF) {
-            isLastLine = true;
+    // Size the buffer from the file size if possible (+1 so EOF is seen)
+    if (fstat(fileno(dict), &info) == 0 && S_ISREG(info.st_mode)) {
+        capacity = info.st_size + 1;
+    }
+
+    char *buffer = malloc(capacity);
+    size_t size = 0;
+    size_t bytesRead;
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    while ((bytesRead = fread(buffer + size, 1, capacity - size, dict)) > 0) {
+        size += bytesRead;
+        // Grow the buffer if the file is larger than expected
+        if (size == capacity) {
+            capacity *= 2;
+            char *grown = realloc(buffer, capacity);
+            if (grown == NULL) {
+                free(buffer);
+                return NULL;
+            }
+            buffer = grown;
+        }
+    }
+
+    // fread stops at errors as well as the end of the file
+    if (ferror(dict)) {
+        free(buffer);
+        return NULL;
+    }
+
+    *length = size;
+    return buffer;
+}
+
+/*
+ * Copies the line of length lineLength at line into a new word.
+ * The word's length, whether it is all letters and its hash are stored at
+ * length, isAlpha and hash.
+ *
+ * A '\0' in the line ends the word early (as strcpy would).
+ */
+static char *copy_word(const char *line, int lineLength, int *length,
+        bool *isAlpha, unsigned int *hash) {
+    bool alpha = true;
+    int wordLength = lineLength;
+    unsigned int wordHash = HASH_SEED;
+
+    for (int i = 0; i < lineLength; ++i) {
+        if (line[i] == '\0') {
+            wordLength = i;
             break;
         }
+        if (!isalpha((unsigned char) line[i])) {
+            alpha = false;
+        }
+        wordHash = hash_step(wordHash, line[i]);
+    }
 
-        index++;
+    char *word = malloc(wordLength + 1);
+    memcpy(word, line, wordLength);
+    word[wordLength] = '\0';
+
+    *length = wordLength;
+    *isAlpha = alpha;
+    *hash = wordHash;
+    return word;
+}
+
+/*
+ * Grows a table of word counts by length (maxLength + 1 entries) so it has
+ * an entry for the given length. New entries are set to 0.
+ */
+static void grow_length_counts(int **lengthCounts, int *maxLength,
+        int length) {
+    if (length > *maxLength) {
+        *lengthCounts = realloc(*lengthCounts, (length + 1) * sizeof(int));
+        memset(*lengthCounts + *maxLength + 1, 0,
+                (length - *maxLength) * sizeof(int));
+        *maxLength = length;
     }
+}
 
-    // Add end of string character '\0'
-    line[index] = '\0';
+/*
+ * Adds one to the count of all-letter words of a given length
+ */
+static void count_length(int **lengthCounts, int *maxLength, int length) {
+    grow_length_counts(lengthCounts, maxLength, length);
+    (*lengthCounts)[length]++;
+}
 
-    // Create and output the ReadLine struct
-    ReadLine *readLine = malloc(sizeof(ReadLine));
-    readLine->line = line;
-    readLine->isLastLine = isLastLine;
+/*
+ * Splits the '\n' terminated lines of a Chunk into words.
+ * Takes a Chunk as a void pointer so it can be run as a thread.
+ */
+static void *parse_chunk(void *arg) {
+    Chunk *chunk = (Chunk *) arg;
+    int capacity = 0;
+    const char *line = chunk->start;
+    const char *newline;
+
+    chunk->words = NULL;
+    chunk->lengths = NULL;
+    chunk->isAlpha = NULL;
+    chunk->hashes = NULL;
+    chunk->numWords = 0;
+    chunk->lengthCounts = NULL;
+    chunk->maxLength = -1;
 
-    return readLine;
+    while (line < chunk->end
+            && (newline = memchr(line, '\n', chunk->end - line)) != NULL) {
+        // Grow the output arrays as required
+        if (chunk->numWords == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            chunk->words = realloc(chunk->words, capacity * sizeof(char *));
+            chunk->lengths = realloc(chunk->lengths, capacity * sizeof(int));
+            chunk->isAlpha = realloc(chunk->isAlpha, capacity * sizeof(bool));
+            chunk->hashes = realloc(chunk->hashes,
+                    capacity * sizeof(unsigned int));
+        }
+
+        int index = chunk->numWords++;
+        chunk->words[index] = copy_word(line, newline - line,
+                &chunk->lengths[index], &chunk->isAlpha[index],
+                &chunk->hashes[index]);
+        if (chunk->isAlpha[index]) {
+            count_length(&chunk->lengthCounts, &chunk->maxLength,
+                    chunk->lengths[index]);
+        }
+
+        line = newline + 1;
+    }
+
+    return NULL;
 }
 
 /*
- * Frees memory allocated to a ReadLine at a given pointer
+ * Splits buffer[0, length) into at most numChunks Chunks.
+ * The buffer must end in a '\n'; each Chunk ends just after one.
+ * Returns the number of Chunks created.
  */
-static void free_readline(ReadLine *word) {
-    free(word->line);
-    free(word);
+static int split_chunks(const char *buffer, size_t length, int numChunks,
+        Chunk *chunks) {
+    const char *start = buffer;
+    const char *end = buffer + length;
+    int created = 0;
+
+    for (int i = 1; i <= numChunks && start < end; ++i) {
+        const char *chunkEnd = end;
+
+        // Move the target boundary forward to just after the next newline
+        if (i < numChunks) {
+            const char *target = buffer + (length / numChunks) * i;
+            if (target < start) {
+                target = start;
+            }
+            chunkEnd = (const char *) memchr(target, '\n', end - target) + 1;
+        }
+
+        chunks[created].start = start;
+        chunks[created].end = chunkEnd;
+        created++;
+        start = chunkEnd;
+    }
+
+    return created;
+}
+
+/*
+ * Parses each Chunk, concurrently if there is more than one.
+ * Chunks whose thread can't be started are parsed by the calling thread.
+ */
+static void parse_chunks(Chunk *chunks, int numChunks) {
+    pthread_t threads[MAX_CHUNKS];
+    bool started[MAX_CHUNKS];
+
+    if (numChunks < 1) {
+        return;
+    }
+
+    for (int i = 1; i < numChunks; ++i) {
+        started[i] = pthread_create(&threads[i], NULL, parse_chunk,
+                &chunks[i]) == 0;
+    }
+
+    parse_chunk(&chunks[0]);
+
+    for (int i = 1; i < numChunks; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            parse_chunk(&chunks[i]);
+        }
+    }
+}
+
+/*
+ * Returns how many Chunks a buffer of length bytes should be split into
+ */
+static int get_num_chunks(size_t length) {
+    long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t numChunks = length / MIN_CHUNK_SIZE;
+
+    if (numCpus > 0 && numChunks > (size_t) numCpus) {
+        numChunks = numCpus;
+    }
+    if (numChunks > MAX_CHUNKS) {
+        numChunks = MAX_CHUNKS;
+    }
+
+    return numChunks < 1 ? 1 : numChunks;
 }
 
 /*
  * Reads a dictionary file and outputs a WordList containing all the words
  * in the dictionary.
+ *
+ * Every '\n' ends a word (including empty ones). Whatever follows the last
+ * '\n' becomes the final word, with its last character dropped if the file
+ * doesn't end in a newline. Any '\r' is kept as part of the word.
+ *
+ * Returns NULL if the file can't be read or doesn't fit in memory.
  */
 WordList *file_to_wordlist(FILE *dict) {
+    size_t length;
+    char *buffer = read_file(dict, &length);
+    if (buffer == NULL) {
+        return NULL;
+    }
 
-    int numWords = 0;
-    char **words = (char **) malloc(0);
-    ReadLine *nextLine = read_line(dict);
-
-    while (1) { 
-        // Append the nextLine.line to words
-        numWords++;
-        words = (char **) realloc(words, numWords * sizeof(char *));
-        
-        /* 
-         * Allocate memory for the word and then strcpy it into the
-         * correct index in words
-         */
-        words[numWords - 1] = \
-                (char *) calloc(strlen(nextLine->line) + 1, sizeof(char));
-        strcpy(words[numWords - 1], nextLine->line);
-       
-        if (nextLine->isLastLine) {
-            break;
+    // Text after the last newline is the final word, split everything before
+    const char *lastNewline = memrchr(buffer, '\n', length);
+    size_t linesLength = lastNewline ? lastNewline + 1 - buffer : 0;
+
+    Chunk chunks[MAX_CHUNKS];
+    int numChunks = split_chunks(buffer, linesLength,
+            get_num_chunks(linesLength), chunks);
+    parse_chunks(chunks, numChunks);
+
+    // Stitch together the words of each Chunk (+1 for the final word)
+    int numWords = 1;
+    for (int i = 0; i < numChunks; ++i) {
+        numWords += chunks[i].numWords;
+    }
+
+    char **words = malloc(numWords * sizeof(char *));
+    WordMeta *meta = malloc(sizeof(WordMeta));
+    meta->lengths = malloc(numWords * sizeof(int));
+    meta->isAlpha = malloc(numWords * sizeof(bool));
+    meta->hashes = malloc(numWords * sizeof(unsigned int));
+
+    meta->lengthCounts = NULL;
+    meta->maxLength = -1;
+    meta->indexSlots = NULL;
+    meta->indexSize = 0;
+    meta->indexNext = NULL;
+    meta->signatures = NULL;
+    meta->signatureSlots = NULL;
+    meta->signatureSize = 0;
+    meta->signatureNext = NULL;
+
+    int index = 0;
+    for (int i = 0; i < numChunks; ++i) {
+        int count = chunks[i].numWords;
+        memcpy(&words[index], chunks[i].words, count * sizeof(char *));
+        memcpy(&meta->lengths[index], chunks[i].lengths, count * sizeof(int));
+        memcpy(&meta->isAlpha[index], chunks[i].isAlpha, count * sizeof(bool));
+        memcpy(&meta->hashes[index], chunks[i].hashes,
+                count * sizeof(unsigned int));
+        index += count;
+
+        // Add the chunk's length counts to the dictionary's
+        grow_length_counts(&meta->lengthCounts, &meta->maxLength,
+                chunks[i].maxLength);
+        for (int length = 0; length <= chunks[i].maxLength; ++length) {
+            meta->lengthCounts[length] += chunks[i].lengthCounts[length];
         }
 
-        // Free memory allocated to nextLine before reading the next line to it
-        free_readline(nextLine);
+        free(chunks[i].words);
+        free(chunks[i].lengths);
+        free(chunks[i].isAlpha);
+        free(chunks[i].hashes);
+        free(chunks[i].lengthCounts);
+    }
 
-        nextLine = read_line(dict);
+    int tailLength = length - linesLength;
+    if (tailLength > 0) {
+        tailLength--;
+    }
+    words[index] = copy_word(buffer + linesLength, tailLength,
+            &meta->lengths[index], &meta->isAlpha[index],
+            &meta->hashes[index]);
+    if (meta->isAlpha[index]) {
+        count_length(&meta->lengthCounts, &meta->maxLength,
+                meta->lengths[index]);
     }
 
+    free(buffer);
 
     // Create the output WordList struct
     WordList *wordList = malloc(sizeof(WordList));
     wordList->words = words;
     wordList->numWords = numWords;
-
-    // Free nextLine
-    free_readline(nextLine);
+    wordList->meta = meta;
 
     return wordList;
 }
@@ -2,23 +2,32 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
-#include <ctype.h>
-#include "wordList.h"
-#include "readDict.h"
-#include "searchMethods.h"
+#include <strings.h>
+#include "libsearch.h"
 
 // Minimum valid possible amount of input arguments (command name + pattern)
 #define MIN_INPUT_ARGS 2
+// Minimum amount of input arguments with -check (command name only)
+#define MIN_CHECK_ARGS 1
+// Maximum amount of options (one search option, -sort, -explain, -extended)
+#define MAX_OPTIONS 4
 
 /*
  * Numbers corresponding to search options, these values are used for the
- * searchOption variable of OptionArg structs
+ * searchOption variable of OptionArg structs and match the order of
+ * validOptions in get_option_num
  */
 #define INVALID_OPTION (-1)
 #define EXACT 0
 #define PREFIX 1
 #define ANYWHERE 2
 #define SORT 3
+#define EXPLAIN 4
+#define CHECK 5
+#define EXTENDED 6
+#define ANAGRAM 7
+#define SUBANAGRAM 8
+#define NUM_VALID_OPTIONS 9
 
 /*
  * Struct for storing the pattern and filepath inputs to search
@@ -28,122 +37,130 @@ typedef struct {
     char *filePath;
 } NonOptionArgs;
 
+/*
+ * Struct for storing a list of strings (input options or unknown words)
+ * and how many there are
+ */
+typedef struct {
+    char **strings;
+    int numStrings;
+} StringList;
+
 /*
  * Struct for storing search options of a search:
  * searchOption: int corresponding to a searchOption macro
  * sortEnabled: int, 0 or 1 depending if sort is enabled
+ * explainEnabled: int, 0 or 1 depending if the query plan should be printed
+ * extendedEnabled: int, 0 or 1 depending if '*' and [classes] are allowed
  * numOptions: int of total search options given
  */
 typedef struct {
     int searchOption;
     int sortEnabled;
+    int explainEnabled;
+    int extendedEnabled;
     int numOptions;
 } OptionArgs;
 
-/*
- * Output after successful search.
- * outputList: Output word list of matched words (unsorted)
- * selectedOptions: Input options given to search as OptionArgs struct
- */
-typedef struct {
-    WordList *outputList;
-    OptionArgs *selectedOptions;
-} SearchOutput;
-
-static SearchOutput search_and_get_output(int argc, char  **argv);
 static OptionArgs *get_args(int argc, char **argv);
 static NonOptionArgs *get_pattern_and_filepath(int nonOptionCount,
-        int argc, char **argv);
-static bool check_pattern(char *pattern);
+        bool hasPattern, int argc, char **argv);
 static void free_non_option_args(NonOptionArgs *options);
-static WordList *run_search(int searchOption, char *pattern, FILE *dict);
-
-int main(int argc, char **argv) {
-
-    SearchOutput output = search_and_get_output(argc, argv);
-
-    // Sort list if -sort option given
-    if (output.selectedOptions->sortEnabled) {
-        sort_wordlist(output.outputList);
-    }
-    free(output.selectedOptions);
-
-    // Print matched words
-    for (int i = 0; i < (output.outputList)->numWords; ++i) {
-        printf("%s\n", (output.outputList)->words[i]);
-    }
-    free_wordlist(output.outputList);
-
-    return 0;
-}
+static int compile_search(OptionArgs *selectedOptions, char *pattern,
+        SearchQuery **query);
+static void print_pattern_error(OptionArgs *selectedOptions, int status);
+static int check_file(char *filePath);
+static int run_search(OptionArgs *selectedOptions, SearchQuery *query,
+        SearchDict *dict);
+static StringList *check_words(SearchDict *dict, FILE *input);
+static int compare_strings(const void *p, const void *q);
+static void free_string_list(StringList *list);
 
 /*
- * Given input arguments to main (argc, argv), do the following:
- * Check for invalid input arguments, pattern and file and exit with -1
- * if found incorrect input arguments.
+ * Checks for invalid input arguments and file, exiting with -1 if found.
  *
- * Else runs search on given or default dictionary as per the given options.
- *
- * Returns SearchOutput struct containing:
- * - unsorted WordList of matches
- * - OptionArgs struct corresponding to the given search options
+ * Else runs search on given or default dictionary as per the given options
+ * and prints the matched words, exiting with -1 if there were none or the
+ * pattern was invalid.
+ * With -check, the words read from stdin that aren't in the dictionary
+ * are printed instead.
  */
-static SearchOutput search_and_get_output(int argc, char  **argv) {
+int main(int argc, char **argv) {
     // Check arguments are valid and get search options
     OptionArgs *selectedOptions = get_args(argc, argv);
     if (selectedOptions->searchOption == INVALID_OPTION) {
-        fprintf(stderr, "Usage: search [-exact|-prefix|-anywhere]"
-                " [-sort] pattern [filename]\n");
+        fprintf(stderr, "Usage: search [-exact|-prefix|-anywhere|-anagram"
+                "|-subanagram] [-sort] [-explain] [-extended] pattern"
+                " [filename]\n"
+                "       search -check [-sort] [filename]\n");
         free(selectedOptions);
         exit(-1);
     }
 
+    bool checkWords = selectedOptions->searchOption == CHECK;
     int nonOptionCount = argc - 1 - selectedOptions->numOptions;
-    NonOptionArgs *patternAndPath = \
-            get_pattern_and_filepath(nonOptionCount, argc, argv);
+    NonOptionArgs *patternAndPath = get_pattern_and_filepath(nonOptionCount,
+            !checkWords, argc, argv);
+
+    // Compile the pattern first, so an invalid one doesn't read the file
+    SearchQuery *query = NULL;
+    int patternStatus = SEARCH_OK;
+    if (!checkWords) {
+        patternStatus = compile_search(selectedOptions,
+                patternAndPath->pattern, &query);
+    }
 
-    // Check dictionary file path validity, then read dict file
-    if (fopen(patternAndPath->filePath, "r") == NULL) {
+    /*
+     * Read the dictionary file, or if the pattern is invalid just check the
+     * file can be opened, as a file error is reported before a pattern error
+     */
+    SearchDict *dict = NULL;
+    int fileStatus = patternStatus == SEARCH_OK
+            ? search_dict_open(patternAndPath->filePath, &dict)
+            : check_file(patternAndPath->filePath);
+    if (fileStatus != SEARCH_OK) {
         fprintf(stderr, "search: file \"%s\" can not be opened\n", \
                 patternAndPath->filePath);
+        search_query_free(query);
         free(selectedOptions);
         free_non_option_args(patternAndPath);
         exit(-1);
     }
-    FILE *dict = fopen(patternAndPath->filePath, "r");
-
-    // Check if pattern is valid
-    if (!check_pattern(patternAndPath->pattern)) {
-        fprintf(stderr, "search: pattern should only "
-                "contain question marks and letters\n");
-        free_non_option_args(patternAndPath);
+    if (patternStatus != SEARCH_OK) {
+        print_pattern_error(selectedOptions, patternStatus);
         free(selectedOptions);
-        fclose(dict);
+        free_non_option_args(patternAndPath);
         exit(-1);
     }
 
-    WordList *outputList = run_search(selectedOptions->searchOption,
-            patternAndPath->pattern, dict);
-    fclose(dict);
-    free_non_option_args(patternAndPath);
-
-    // Return -1 if 0 words were found
-    if (outputList->numWords < 1) {
-        free(outputList);
-        free(selectedOptions);
-        exit(-1);
+    int status = 0;
+    if (checkWords) {
+        // Print the words on stdin that aren't in the dictionary
+        StringList *unknownWords = check_words(dict, stdin);
+        if (selectedOptions->sortEnabled) {
+            qsort(unknownWords->strings, unknownWords->numStrings,
+                    sizeof(char *), compare_strings);
+        }
+        for (int i = 0; i < unknownWords->numStrings; ++i) {
+            printf("%s\n", unknownWords->strings[i]);
+        }
+        free_string_list(unknownWords);
+    } else {
+        status = run_search(selectedOptions, query, dict);
+        search_query_free(query);
     }
 
-    SearchOutput output;
-    output.outputList = outputList;
-    output.selectedOptions = selectedOptions;
-    return output;
+    search_dict_close(dict);
+    free_non_option_args(patternAndPath);
+    free(selectedOptions);
+
+    return status;
 }
 
 /*
- * Retrives input option arguments in argv to a WordList
+ * Retrives input option arguments in argv to a StringList
  */
-static WordList *get_input_options(int argc, char **argv) {
+static StringList *get_input_options(int argc, char **argv) {
     int optionCount = 0;
     char **options = (char **) malloc(0);
 
@@ -155,7 +172,7 @@ static WordList *get_input_options(int argc, char **argv) {
              * i.e. if it's the last argument and the previous argument didn't
              * start with '-' (pattern cannot have '-')
              */
-            if (i == argc - 1 && argv[argc - 2][0] != '-') {
+            if (i == argc - 1 && i > 1 && argv[argc - 2][0] != '-') {
                 continue;
             }
 
@@ -169,10 +186,10 @@ static WordList *get_input_options(int argc, char **argv) {
         }
     }
 
-    // Create and return the output WordList
-    WordList *optionList = malloc(sizeof(WordList));
-    optionList->numWords = optionCount;
-    optionList->words = options;
+    // Create and return the output StringList
+    StringList *optionList = malloc(sizeof(StringList));
+    optionList->numStrings = optionCount;
+    optionList->strings = options;
 
     return optionList;
 }
@@ -182,10 +199,11 @@ static WordList *get_input_options(int argc, char **argv) {
  */
 static int get_option_num(char *option) {
     int optionNum = -1;
-    char *validOptions[] = {"-exact", "-prefix", "-anywhere", "-sort"};
+    char *validOptions[] = {"-exact", "-prefix", "-anywhere", "-sort",
+            "-explain", "-check", "-extended", "-anagram", "-subanagram"};
 
     // Find which validOption the given option matches
-    for (int i = 0; i < 4; ++i) {
+    for (int i = 0; i < NUM_VALID_OPTIONS; ++i) {
         if (strcmp(option, validOptions[i]) == 0) {
             optionNum = i;
         }
@@ -195,15 +213,39 @@ static int get_option_num(char *option) {
 }
 
 /*
- * Sets search & sort options of an OptionArg given an input option as a string
+ * Sets search, sort, explain & extended options of an OptionArg given an
+ * input option as a string.
+ * searchGiven is set once a search option has been seen, so that a second
+ * search option (or any repeated option) makes the options invalid.
  */
-static void set_selected_options(OptionArgs *selectedOptions, char *option) {
-    // Set searchOption if option is one of -anywhere, -exact or -prefix
-    if (get_option_num(option) <= ANYWHERE) {
-        selectedOptions->searchOption = get_option_num(option);
+static void set_selected_options(OptionArgs *selectedOptions, char *option,
+        bool *searchGiven) {
+    int optionNum = get_option_num(option);
+
+    // Set searchOption if option is a search option (e.g. -exact or -check)
+    if (optionNum <= ANYWHERE || optionNum == CHECK || optionNum == ANAGRAM
+            || optionNum == SUBANAGRAM) {
+        selectedOptions->searchOption = *searchGiven ? INVALID_OPTION \
+                : optionNum;
+        *searchGiven = true;
     // Set sortEnabled if option is -sort
-    } else if (get_option_num(option) == SORT) {
+    } else if (optionNum == SORT) {
+        if (selectedOptions->sortEnabled) {
+            selectedOptions->searchOption = INVALID_OPTION;
+        }
         selectedOptions->sortEnabled = 1;
+    // Set explainEnabled if option is -explain
+    } else if (optionNum == EXPLAIN) {
+        if (selectedOptions->explainEnabled) {
+            selectedOptions->searchOption = INVALID_OPTION;
+        }
+        selectedOptions->explainEnabled = 1;
+    // Set extendedEnabled if option is -extended
+    } else if (optionNum == EXTENDED) {
+        if (selectedOptions->extendedEnabled) {
+            selectedOptions->searchOption = INVALID_OPTION;
+        }
+        selectedOptions->extendedEnabled = 1;
     }
 }
 
@@ -214,92 +256,79 @@ static void set_selected_options(OptionArgs *selectedOptions, char *option) {
  * Returns selected options as an OptionArgs struct
  */
 static OptionArgs *get_args(int argc, char **argv) {
-    OptionArgs *selectedOptions = malloc(sizeof(OptionArgs));
+    OptionArgs *selectedOptions = calloc(1, sizeof(OptionArgs));
     selectedOptions->searchOption = EXACT;
-    // Get WordList of -(option) arguments
-    WordList *optionList = get_input_options(argc, argv);
+    // Get StringList of -(option) arguments
+    StringList *optionList = get_input_options(argc, argv);
 
     // Check if number of -option arguments is correct
-    int numOptions = optionList->numWords;
-    if (numOptions > 2) {
+    int numOptions = optionList->numStrings;
+    if (numOptions > MAX_OPTIONS) {
         selectedOptions->searchOption = INVALID_OPTION;
     }
     selectedOptions->numOptions = numOptions;
 
-    // Check if number of input args is correct
-    if (!(argc >= MIN_INPUT_ARGS + numOptions \
-            && (argc <= (MIN_INPUT_ARGS + numOptions + 1)))) {
+    // Set each option, stopping at the first invalid or repeated option
+    bool searchGiven = false;
+    for (int i = 0; i < numOptions
+            && selectedOptions->searchOption != INVALID_OPTION; ++i) {
+        set_selected_options(selectedOptions, optionList->strings[i],
+                &searchGiven);
+    }
+
+    // Extended patterns are only for exact, prefix and anywhere searches
+    if (selectedOptions->extendedEnabled
+            && (selectedOptions->searchOption == ANAGRAM
+            || selectedOptions->searchOption == SUBANAGRAM)) {
         selectedOptions->searchOption = INVALID_OPTION;
     }
 
-    if (selectedOptions->searchOption != INVALID_OPTION) {
-        switch (numOptions) {
-            case 1:
-                // Set search option
-                set_selected_options(selectedOptions, optionList->words[0]);
-                break;
-            case 2:
-                for (int i = 0; i < 2; ++i) {
-                    // Set selected option
-                    set_selected_options(selectedOptions,
-                            optionList->words[i]);
-                    if (selectedOptions->searchOption == INVALID_OPTION) {
-                        break;
-                    }
-                }
-                // Check for sort option was given and for identical options
-                if (!selectedOptions->sortEnabled ||
-                        !strcmp(optionList->words[0], optionList->words[1])) {
-                    selectedOptions->searchOption = INVALID_OPTION;
-                }
-                break;
-            default:
-                // If no given seach options, set the defaults
-                selectedOptions->sortEnabled = 0;
-                selectedOptions->searchOption = EXACT;
-                break;
+    // -check has no pattern and no query plan to explain
+    int minArgs = MIN_INPUT_ARGS;
+    if (selectedOptions->searchOption == CHECK) {
+        minArgs = MIN_CHECK_ARGS;
+        if (selectedOptions->explainEnabled
+                || selectedOptions->extendedEnabled) {
+            selectedOptions->searchOption = INVALID_OPTION;
         }
     }
 
-    free_wordlist(optionList);
+    // Check if number of input args is correct
+    if (!(argc >= minArgs + numOptions \
+            && (argc <= (minArgs + numOptions + 1)))) {
+        selectedOptions->searchOption = INVALID_OPTION;
+    }
+
+    free_string_list(optionList);
     return selectedOptions;
 }
 
 /*
- * Retrives pattern and filename when search is run to NonOptionArgs struct
+ * Retrives pattern and filename when search is run to NonOptionArgs struct.
+ * If hasPattern is false (i.e. for -check) the pattern is left empty and
+ * a single non option arg is interpreted as the filename.
  */
 static NonOptionArgs *get_pattern_and_filepath(int nonOptionCount,
-        int argc, char **argv){
+        bool hasPattern, int argc, char **argv){
 
     NonOptionArgs *result = malloc(sizeof(NonOptionArgs));
+    int numPatterns = hasPattern ? 1 : 0;
+
+    // The pattern is the first non option arg
+    char *pattern = hasPattern ? argv[argc - nonOptionCount] : "";
+    result->pattern = calloc(strlen(pattern) + 1, sizeof(char));
+    strcpy(result->pattern, pattern);
 
     /*
-     * If theres one non option arg, interpret it as the pattern and save
-     * to result
+     * If there's a non option arg after the pattern, interpret it as the
+     * file path, else use the default dictionary
      */
-    if (nonOptionCount == 1) {
-        // Set the pattern
-        result->pattern = calloc(strlen(argv[argc - 1]) + 1,
-                sizeof(char));
-        strcpy(result->pattern, argv[argc - 1]);
-
-        char *defaultPath = "/usr/share/dict/words";
-        result->filePath = calloc(strlen(defaultPath) + 1, sizeof(char));
-        strcpy(result->filePath, defaultPath);
-
-    } else {
-        /*
-         * Else both pattern and file path are given options, save these to
-         * result
-         */
-        result->pattern = calloc(strlen(argv[argc - 2]) + 1,
-                sizeof(char));
-        strcpy(result->pattern, argv[argc - 2]);
-
-        result->filePath = calloc(strlen(argv[argc - 1]) + 1,
-                sizeof(char));
-        strcpy(result->filePath, argv[argc - 1]);
+    char *filePath = "/usr/share/dict/words";
+    if (nonOptionCount > numPatterns) {
+        filePath = argv[argc - 1];
     }
+    result->filePath = calloc(strlen(filePath) + 1, sizeof(char));
+    strcpy(result->filePath, filePath);
 
     return result;
 }
@@ -314,44 +343,159 @@ static void free_non_option_args(NonOptionArgs *options) {
 }
 
 /*
- * Checks if a pattern given as a string is valid as per the assignment spec
+ * Returns the libsearch mode (SEARCH_EXACT etc.) of a search option
  */
-static bool check_pattern(char *pattern) {
-
-    bool result = true;
-    
-    // Check if each character in the pattern is a letter or ?
-    for (int i = 0; i < strlen(pattern); ++i) {
-        if (!isalpha(pattern[i]) && pattern[i] != '?') {
-            result = false;
-            break;
-        }
+static int get_search_mode(int searchOption) {
+    switch (searchOption) {
+        case PREFIX:
+            return SEARCH_PREFIX;
+        case ANYWHERE:
+            return SEARCH_ANYWHERE;
+        case ANAGRAM:
+            return SEARCH_ANAGRAM;
+        case SUBANAGRAM:
+            return SEARCH_SUBANAGRAM;
+        default:
+            return SEARCH_EXACT;
     }
+}
 
-    return result;
+/*
+ * Callback for search_query_run, prints a matched word and counts it in
+ * the int pointed to by data
+ */
+static int print_word(const char *word, void *data) {
+    printf("%s\n", word);
+    (*(int *) data)++;
+
+    return 0;
 }
 
 /*
- * Searches through a dictionary file with given pattern and search options
+ * Compiles a pattern with the given search options into a query stored at
+ * query. Returns the status from search_query_compile.
  */
-static WordList *run_search(int searchOption, char *pattern, FILE *dict) {
-    WordList *dictList = file_to_wordlist(dict);
-    WordList *outputList;
+static int compile_search(OptionArgs *selectedOptions, char *pattern,
+        SearchQuery **query) {
+    int flags = 0;
+    if (selectedOptions->sortEnabled) {
+        flags |= SEARCH_SORT;
+    }
+    if (selectedOptions->extendedEnabled) {
+        flags |= SEARCH_EXTENDED;
+    }
+    // Each search runs once, so scanning beats building the hash index
+    flags |= SEARCH_ONCE;
 
-    // Run different search mode depending on given searchOption
-    switch (searchOption) {
-        case PREFIX:
-            outputList = prefix_match(pattern, dictList);
-            break;
-        case ANYWHERE:
-            outputList = anywhere_match(pattern, dictList);
-            break;
-        default:
-            outputList = exact_match(pattern, dictList);
+    return search_query_compile(pattern,
+            get_search_mode(selectedOptions->searchOption), flags, query);
+}
+
+/*
+ * Prints why a pattern failed to compile, given the status from
+ * compile_search
+ */
+static void print_pattern_error(OptionArgs *selectedOptions, int status) {
+    if (status == SEARCH_ERR_PATTERN && selectedOptions->extendedEnabled) {
+        fprintf(stderr, "search: pattern should only contain question "
+                "marks, letters, '*' and classes such as [abc]\n");
+    } else if (status == SEARCH_ERR_PATTERN) {
+        fprintf(stderr, "search: pattern should only "
+                "contain question marks and letters\n");
+    } else {
+        fprintf(stderr, "search: %s\n", search_strerror(status));
+    }
+}
+
+/*
+ * Checks a file can be opened without reading it.
+ * Returns SEARCH_OK, or SEARCH_ERR_OPEN if it can't be opened.
+ */
+static int check_file(char *filePath) {
+    FILE *file = fopen(filePath, "r");
+    if (file == NULL) {
+        return SEARCH_ERR_OPEN;
+    }
+
+    fclose(file);
+    return SEARCH_OK;
+}
+
+/*
+ * Searches through a dictionary with a compiled query, printing the matched
+ * words. The query plan is printed to stderr first if -explain was given.
+ *
+ * Returns 0 if any words were printed, else -1.
+ */
+static int run_search(OptionArgs *selectedOptions, SearchQuery *query,
+        SearchDict *dict) {
+    if (selectedOptions->explainEnabled) {
+        search_query_explain(query, dict, stderr);
     }
 
-    // Clean up the word list of the dictionary
-    free_wordlist(dictList);
+    int numPrinted = 0;
+    search_query_run(query, dict, print_word, &numPrinted);
+
+    return numPrinted > 0 ? 0 : -1;
+}
+
+/*
+ * Checks words read from input (one per line) against a dictionary,
+ * ignoring case.
+ * Line endings ("\n" or "\r\n") are removed and empty lines are skipped.
+ *
+ * Returns StringList of the words not in the dictionary, in the order they
+ * were read.
+ */
+static StringList *check_words(SearchDict *dict, FILE *input) {
+    int numUnknown = 0;
+    char **unknownWords = (char **) malloc(0);
+    char *line = NULL;
+    size_t lineSize = 0;
+    ssize_t lineLength;
+
+    while ((lineLength = getline(&line, &lineSize, input)) != -1) {
+        // Remove the line ending
+        while (lineLength > 0 && (line[lineLength - 1] == '\n'
+                || line[lineLength - 1] == '\r')) {
+            line[--lineLength] = '\0';
+        }
+
+        if (lineLength == 0 || search_dict_contains(dict, line)) {
+            continue;
+        }
+
+        // Add the unknown word to unknownWords
+        numUnknown++;
+        unknownWords = (char **) realloc(unknownWords,
+                numUnknown * sizeof(char *));
+        unknownWords[numUnknown - 1] = calloc(lineLength + 1, sizeof(char));
+        strcpy(unknownWords[numUnknown - 1], line);
+    }
+    free(line);
+
+    // Create and return the output StringList
+    StringList *outputList = malloc(sizeof(StringList));
+    outputList->strings = unknownWords;
+    outputList->numStrings = numUnknown;
 
     return outputList;
 }
+
+/*
+ * qsort comparator for strings, ignoring case (the same order as SEARCH_SORT)
+ */
+static int compare_strings(const void *p, const void *q) {
+    return strcasecmp(*(char * const *) p, *(char * const *) q);
+}
+
+/*
+ * Frees a StringList and each of its strings
+ */
+static void free_string_list(StringList *list) {
+    for (int i = 0; i < list->numStrings; ++i) {
+        free(list->strings[i]);
+    }
+    free(list->strings);
+    free(list);
+}
@@ -1,3 +1,6 @@
+// For strcasestr
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -42,6 +45,42 @@ static bool is_valid_char(char inputLetter, char dictLetter) {
     return result;
 }
 
+/*
+ * Returns the length of the word at index in a WordList, using the
+ * dictionary's metadata if it has any.
+ */
+static int word_length(WordList *dictList, int index) {
+    if (dictList->meta != NULL) {
+        return dictList->meta->lengths[index];
+    }
+    return strlen(dictList->words[index]);
+}
+
+/*
+ * Checks if the word at index in a WordList contains only letters, using the
+ * dictionary's metadata if it has any.
+ */
+static bool word_is_alpha(WordList *dictList, int index) {
+    if (dictList->meta != NULL) {
+        return dictList->meta->isAlpha[index];
+    }
+    return check_str_alpha(dictList->words[index]);
+}
+
+/*
+ * Checks if the first patternLength letters of word match a pattern.
+ * word must be at least patternLength characters long.
+ */
+static bool match_at(char *pattern, int patternLength, char *word) {
+    for (int i = 0; i < patternLength; ++i) {
+        if (!is_valid_char(pattern[i], word[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /* Performs prefix or exact match against a dictionary of words dictList given
  * as a WordList struct.
  * Returns a mask (bool arr) corresponding to dictList
@@ -52,46 +91,37 @@ static bool *bool_mask_match(char *pattern,
         WordList *dictList, bool matchLength) {
 
     bool *wordFlags = fill_bool(dictList->numWords);
+    if (wordFlags == NULL) {
+        return NULL;
+    }
+    int patternLength = strlen(pattern);
 
     for (int word = 0; word < dictList->numWords; ++word) {
+        int wordLength = word_length(dictList, word);
 
         /* If length matching is enabled, flag false if the input word length
          * is not equal to the length of the dict word length.
          */
-        if (matchLength && strlen(pattern) \
-                != strlen(dictList->words[word])) {
+        if (matchLength && patternLength != wordLength) {
             wordFlags[word] = false;
             continue;
         }
        
         // Flag a word as false if it contains non-letters
-        if (!check_str_alpha(dictList->words[word])) {
+        if (!word_is_alpha(dictList, word)) {
             wordFlags[word] = false;
             continue;
         }
 
-        // Empty input pattern matches everything 
-        if (strlen(pattern) == 0) {
-            wordFlags[word] = true;
-            continue;
-        }
-
         // Flag a word as false if its length is less than the input string 
-        if (strlen(pattern) > strlen(dictList->words[word])) {
+        if (patternLength > wordLength) {
             wordFlags[word] = false;
             continue;
         }
 
-        for (int i = 0; i < strlen(pattern); ++i) {
-            if (!is_valid_char(pattern[i], (dictList->words)[word][i])) {
-                wordFlags[word] = false;
-                /* Break and move onto the next word as
-                 * soon as the current word has
-                 * been flagged false.
-                 */
-                break;
-            }
-        }
+        // Empty input pattern matches everything, so is never flagged false
+        wordFlags[word] = match_at(pattern, patternLength,
+                dictList->words[word]);
     }
 
     return wordFlags;
@@ -100,75 +130,118 @@ static bool *bool_mask_match(char *pattern,
 /*
  * Runs exact matching on a WordList given an input pattern and a WordList of
  * a dictionary.
- * Returns pointer to WordList of matching words.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
  */
-WordList *exact_match(char *pattern, WordList *dictList) {
-    // Run exact matching
-    bool *wordFlags = bool_mask_match(pattern, dictList, true);
-
-    // Get and return output wordList given the mask wordFlags
-    return string_bool_mask(wordFlags, dictList);
+bool *exact_match(char *pattern, WordList *dictList) {
+    return bool_mask_match(pattern, dictList, true);
 }
 
 /*
  * Runs prefix matching on a WordList given an input pattern and a WordList of
  * a dictionary.
- * Returns pointer to WordList of matching words.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
  */
-WordList *prefix_match(char *pattern, WordList *dictList) {
-    // Run prefix matching
-    bool *wordFlags = bool_mask_match(pattern, dictList, false);
-
-    // Get and return output WordList given the mask wordFlags
-    return string_bool_mask(wordFlags, dictList);
+bool *prefix_match(char *pattern, WordList *dictList) {
+    return bool_mask_match(pattern, dictList, false);
 }
 
 /*
  * Runs anywhere matching on a WordList given an input pattern and a WordList
  * of a dictionary.
- * Returns pointer to WordList of matching words.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
  */
-WordList *anywhere_match(char *pattern, WordList *dictList) {
+bool *anywhere_match(char *pattern, WordList *dictList) {
     bool *wordFlags = (bool*) calloc(dictList->numWords, sizeof(bool));
-   
-    /*
-     * Temporary WordList only containing one word.
-     * Used to store the current one being checked for the pattern
-     */
-    WordList tempList;
-    tempList.numWords = 1;
-    tempList.words = (char **) malloc(sizeof(char *) * 1);
+    if (wordFlags == NULL) {
+        return NULL;
+    }
+    int patternLength = strlen(pattern);
 
     for (int word = 0; word < (dictList->numWords); word++) {
         char *currentWord = dictList->words[word];
+        int wordLength = word_length(dictList, word);
 
         // Flag false if dict word contains non-letters
-        if (!check_str_alpha(currentWord)) {
+        if (!word_is_alpha(dictList, word)) {
             wordFlags[word] = false;
             continue;
         }
 
         /*
          * Process for anywhere matching:
-         * Take all letters of the word from the ith letter as a word and run
-         * prefix matching on it.
-         * Flag word as true and exit loop if patter is matched, else
+         * Try to match the pattern starting from the ith letter of the word.
+         * Flag word as true and exit loop if pattern is matched, else
          * repeat from the i+1th letter.
-         *
-         * (A rather naive algorithm, but hey, it works! :D )
+         * (An empty pattern matches any word that has at least one letter)
          */
-        for (int i = 0; i < strlen(currentWord); i++) {
-            tempList.words[0] = &(currentWord[i]);
-            if (bool_mask_match(pattern, &tempList, false)[0]) {
+        for (int i = 0; i < wordLength && i + patternLength <= wordLength;
+                i++) {
+            if (match_at(pattern, patternLength, &currentWord[i])) {
                 wordFlags[word] = true;
                 break;
             }
         }
     }
 
-    // Free memory allocated to the single word stored in tempList
-    free(tempList.words);
-    
-    // Get and return the output WordList given the mask wordFlags
-    return string_bool_mask(wordFlags, dictList);
+    return wordFlags;
+}
+
+/*
+ * Finds every all-letter word in a dictionary with a length from minLength
+ * to maxLength (inclusive), i.e. the words matched by a pattern made only
+ * of question marks.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
+ */
+bool *length_match(int minLength, int maxLength, WordList *dictList) {
+    bool *wordFlags = (bool *) malloc(dictList->numWords * sizeof(bool));
+    if (wordFlags == NULL) {
+        return NULL;
+    }
+
+    for (int word = 0; word < dictList->numWords; ++word) {
+        int wordLength = word_length(dictList, word);
+        wordFlags[word] = wordLength >= minLength && wordLength <= maxLength
+                && word_is_alpha(dictList, word);
+    }
+
+    return wordFlags;
+}
+
+/*
+ * Runs exact, prefix or anywhere matching (given by searchOption) for a
+ * pattern containing only letters, comparing whole strings at a time rather
+ * than one character at a time.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
+ */
+bool *literal_match(char *pattern, int searchOption, WordList *dictList) {
+    bool *wordFlags = (bool *) calloc(dictList->numWords, sizeof(bool));
+    if (wordFlags == NULL) {
+        return NULL;
+    }
+    int patternLength = strlen(pattern);
+
+    for (int word = 0; word < dictList->numWords; ++word) {
+        char *currentWord = dictList->words[word];
+        int wordLength = word_length(dictList, word);
+
+        // Only all-letter words at least as long as the pattern can match
+        if (wordLength < patternLength || !word_is_alpha(dictList, word)) {
+            continue;
+        }
+
+        switch (searchOption) {
+            case PREFIX:
+                wordFlags[word] = !strncasecmp(currentWord, pattern,
+                        patternLength);
+                break;
+            case ANYWHERE:
+                wordFlags[word] = strcasestr(currentWord, pattern) != NULL;
+                break;
+            default:
+                wordFlags[word] = wordLength == patternLength
+                        && !strcasecmp(currentWord, pattern);
+        }
+    }
+
+    return wordFlags;
 }
@@ -1,10 +1,20 @@
 #ifndef SEARCHMETHODS_H
 #define SEARCHMETHODS_H
 
+#include <stdbool.h>
 #include "wordList.h"
 
-WordList *exact_match(char *pattern, WordList *dictList);
-WordList *prefix_match(char *pattern, WordList *dictList);
-WordList *anywhere_match(char *pattern, WordList *dictList);
+// Search modes, numbered the same as the SEARCH_ modes of libsearch.h
+#define EXACT 0
+#define PREFIX 1
+#define ANYWHERE 2
+#define ANAGRAM 3
+#define SUBANAGRAM 4
+
+bool *exact_match(char *pattern, WordList *dictList);
+bool *prefix_match(char *pattern, WordList *dictList);
+bool *anywhere_match(char *pattern, WordList *dictList);
+bool *length_match(int minLength, int maxLength, WordList *dictList);
+bool *literal_match(char *pattern, int searchOption, WordList *dictList);
 
 #endif //SEARCHMETHODS_H
@@ -0,0 +1,265 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <limits.h>
+#include "signatureIndex.h"
+#include "chainedIndex.h"
+#include "wordIndex.h"
+#include "wordList.h"
+
+// Number of letters counted in a signature
+#define NUM_LETTERS 26
+
+/*
+ * A signature as a vector, so all 26 letter counts are compared at once
+ * (see letter_deficit)
+ */
+typedef unsigned char LetterCounts __attribute__((vector_size(SIGNATURE_SIZE)));
+
+/*
+ * Counts the letters in a word (ignoring case) into signature.
+ * Counts stop at UCHAR_MAX, so only words up to that long have exact
+ * signatures (see count_letters for longer words). Any '?' in the word is
+ * counted as a blank.
+ * Returns the number of blanks.
+ */
+static int make_signature(const char *word, unsigned char *signature) {
+    int blanks = 0;
+    memset(signature, 0, SIGNATURE_SIZE);
+
+    for (int i = 0; word[i] != '\0'; ++i) {
+        if (word[i] == '?') {
+            blanks++;
+            continue;
+        }
+        unsigned char *count = &signature[tolower((unsigned char) word[i])
+                - 'a'];
+        if (*count < UCHAR_MAX) {
+            (*count)++;
+        }
+    }
+
+    return blanks;
+}
+
+/*
+ * Counts the letters in a word (ignoring case) into counts (NUM_LETTERS
+ * ints) without the limit of a signature, for words too long to have an
+ * exact signature. Any '?' in the word is counted as a blank.
+ * Returns the number of blanks.
+ */
+static int count_letters(const char *word, int *counts) {
+    int blanks = 0;
+    memset(counts, 0, NUM_LETTERS * sizeof(int));
+
+    for (int i = 0; word[i] != '\0'; ++i) {
+        if (word[i] == '?') {
+            blanks++;
+        } else {
+            counts[tolower((unsigned char) word[i]) - 'a']++;
+        }
+    }
+
+    return blanks;
+}
+
+/*
+ * Returns the hash of a signature
+ */
+static unsigned int hash_signature(const unsigned char *signature) {
+    unsigned int hash = HASH_SEED;
+
+    for (int i = 0; i < SIGNATURE_SIZE; ++i) {
+        hash = (hash ^ signature[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/*
+ * Checks if a word in a dictionary has an exact signature: it must be all
+ * letters and no longer than the largest letter count.
+ * Longer all-letter words are matched with count_letters instead.
+ */
+static bool has_signature(WordList *dictList, int word) {
+    return dictList->meta->isAlpha[word]
+            && dictList->meta->lengths[word] <= UCHAR_MAX;
+}
+
+/*
+ * Key of a dictionary word in the signature index: its signature, which
+ * must already be computed (see WordKey)
+ */
+static const void *signature_key(WordList *dictList, int word,
+        unsigned int *hash) {
+    if (!has_signature(dictList, word)) {
+        return NULL;
+    }
+
+    const unsigned char *signature = &dictList->meta->signatures[(size_t) word
+            * SIGNATURE_SIZE];
+    *hash = hash_signature(signature);
+    return signature;
+}
+
+/*
+ * Checks if a dictionary word has the given signature
+ */
+static bool signature_matches(WordList *dictList, int word, const void *key,
+        unsigned int hash) {
+    return !memcmp(&dictList->meta->signatures[(size_t) word
+            * SIGNATURE_SIZE], key, SIGNATURE_SIZE);
+}
+
+/*
+ * Computes the signature of every all-letter word in a dictionary read by
+ * file_to_wordlist, and indexes the words by signature.
+ *
+ * As with build_word_index, each distinct signature has one slot, and words
+ * sharing it (i.e. anagrams of each other) are chained from that slot in
+ * dictionary order through signatureNext.
+ * Does nothing if the index has already been built.
+ */
+void build_signature_index(WordList *dictList) {
+    WordMeta *meta = dictList->meta;
+    if (meta == NULL || meta->signatures != NULL) {
+        return;
+    }
+
+    unsigned char *signatures = calloc((size_t) dictList->numWords,
+            SIGNATURE_SIZE);
+    meta->signatures = signatures;
+
+    for (int word = 0; word < dictList->numWords; ++word) {
+        if (has_signature(dictList, word)) {
+            make_signature(dictList->words[word],
+                    &signatures[(size_t) word * SIGNATURE_SIZE]);
+        }
+    }
+
+    build_chained_index(dictList, signature_key, signature_matches,
+            &meta->signatureSlots, &meta->signatureSize,
+            &meta->signatureNext);
+}
+
+/*
+ * Finds every all-letter word in a dictionary that is an anagram of a
+ * pattern of only letters (i.e. uses exactly the same letters, ignoring
+ * case), by looking up the pattern's signature.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
+ */
+bool *anagram_match(char *pattern, WordList *dictList) {
+    unsigned char signature[SIGNATURE_SIZE];
+
+    /*
+     * Longer patterns have no exact signature to look up, so their letters
+     * are compared with those of each word of the same length instead
+     */
+    int patternLength = strlen(pattern);
+    if (patternLength > UCHAR_MAX) {
+        return letter_count_match(pattern, patternLength, patternLength,
+                dictList);
+    }
+
+    bool *wordFlags = (bool *) calloc(dictList->numWords, sizeof(bool));
+    if (wordFlags == NULL) {
+        return NULL;
+    }
+    build_signature_index(dictList);
+    WordMeta *meta = dictList->meta;
+    make_signature(pattern, signature);
+    unsigned int slot = find_chain_slot(signature, hash_signature(signature),
+            signature_matches, meta->signatureSlots, meta->signatureSize,
+            dictList);
+
+    for (int word = meta->signatureSlots[slot]; word != -1;
+            word = meta->signatureNext[word]) {
+        wordFlags[word] = true;
+    }
+
+    return wordFlags;
+}
+
+/*
+ * Counts how many of a word's letters aren't available, i.e. the sum over
+ * every letter of how many more times it is in word than in available.
+ * All 26 counts are subtracted (saturating at 0) as one vector.
+ */
+static int letter_deficit(const unsigned char *word,
+        const unsigned char *available) {
+    LetterCounts wordCounts;
+    LetterCounts availableCounts;
+    memcpy(&wordCounts, word, SIGNATURE_SIZE);
+    memcpy(&availableCounts, available, SIGNATURE_SIZE);
+
+    LetterCounts missing = (wordCounts - availableCounts)
+            & (LetterCounts) (wordCounts > availableCounts);
+
+    int deficit = 0;
+    for (int i = 0; i < SIGNATURE_SIZE; ++i) {
+        deficit += missing[i];
+    }
+
+    return deficit;
+}
+
+/*
+ * Counts how many of a word's letters aren't in available (NUM_LETTERS
+ * counts from count_letters), as letter_deficit does for signatures
+ */
+static int long_letter_deficit(const char *word, const int *available) {
+    int counts[NUM_LETTERS];
+    count_letters(word, counts);
+
+    int deficit = 0;
+    for (int i = 0; i < NUM_LETTERS; ++i) {
+        if (counts[i] > available[i]) {
+            deficit += counts[i] - available[i];
+        }
+    }
+
+    return deficit;
+}
+
+/*
+ * Finds every all-letter word in a dictionary with a length from minLength
+ * to maxLength that can be made from the letters of a pattern (ignoring
+ * case), where each '?' in the pattern can stand for any one letter.
+ * Words with signatures are compared by signature. The pattern's signature
+ * may be capped at UCHAR_MAX of a letter, but those words never have more
+ * than that of any letter, so their deficits are still exact.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
+ */
+bool *letter_count_match(char *pattern, int minLength, int maxLength,
+        WordList *dictList) {
+    bool *wordFlags = (bool *) calloc(dictList->numWords, sizeof(bool));
+    if (wordFlags == NULL) {
+        return NULL;
+    }
+    unsigned char available[SIGNATURE_SIZE];
+    int availableCounts[NUM_LETTERS];
+    make_signature(pattern, available);
+    int blanks = count_letters(pattern, availableCounts);
+
+    build_signature_index(dictList);
+    WordMeta *meta = dictList->meta;
+
+    for (int word = 0; word < dictList->numWords; ++word) {
+        int wordLength = meta->lengths[word];
+        if (wordLength < minLength || wordLength > maxLength
+                || !meta->isAlpha[word]) {
+            continue;
+        }
+
+        if (has_signature(dictList, word)) {
+            wordFlags[word] = letter_deficit(&meta->signatures[(size_t) word
+                    * SIGNATURE_SIZE], available) <= blanks;
+        } else {
+            wordFlags[word] = long_letter_deficit(dictList->words[word],
+                    availableCounts) <= blanks;
+        }
+    }
+
+    return wordFlags;
+}
@@ -0,0 +1,18 @@
+#ifndef SIGNATUREINDEX_H
+#define SIGNATUREINDEX_H
+
+#include <stdbool.h>
+#include "wordList.h"
+
+/*
+ * Bytes in a word's signature: a count of each of the 26 letters, padded
+ * to 32 bytes so signatures can be compared as vectors
+ */
+#define SIGNATURE_SIZE 32
+
+void build_signature_index(WordList *dictList);
+bool *anagram_match(char *pattern, WordList *dictList);
+bool *letter_count_match(char *pattern, int minLength, int maxLength,
+        WordList *dictList);
+
+#endif //SIGNATUREINDEX_H
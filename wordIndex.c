@@ -0,0 +1,113 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <strings.h>
+#include "wordIndex.h"
+#include "chainedIndex.h"
+#include "wordList.h"
+
+/*
+ * Returns the case-insensitive hash of a word, the same hash stored for
+ * each dictionary word when it is read
+ */
+unsigned int hash_word(const char *word) {
+    unsigned int hash = HASH_SEED;
+
+    for (int i = 0; word[i] != '\0'; ++i) {
+        hash = hash_step(hash, word[i]);
+    }
+
+    return hash;
+}
+
+/*
+ * Key of a dictionary word in the hash index: the word itself, hashed with
+ * the hash computed while it was read (see WordKey)
+ */
+static const void *word_key(WordList *dictList, int word,
+        unsigned int *hash) {
+    if (!dictList->meta->isAlpha[word]) {
+        return NULL;
+    }
+
+    *hash = dictList->meta->hashes[word];
+    return dictList->words[word];
+}
+
+/*
+ * Checks if a dictionary word is equal (ignoring case) to a word with the
+ * given hash. Hashes are compared first so most other words are skipped
+ * without comparing strings.
+ */
+static bool word_matches(WordList *dictList, int word, const void *key,
+        unsigned int hash) {
+    return dictList->meta->hashes[word] == hash
+            && !strcasecmp(dictList->words[word], (const char *) key);
+}
+
+/*
+ * Builds a hash index of every all-letter word in a dictionary read by
+ * file_to_wordlist, using the word hashes computed while it was read.
+ *
+ * Each distinct word (ignoring case) has one slot. Words equal apart from
+ * case are chained from that slot in dictionary order through indexNext
+ * (see build_chained_index).
+ * Does nothing if the index has already been built.
+ */
+void build_word_index(WordList *dictList) {
+    WordMeta *meta = dictList->meta;
+    if (meta == NULL || meta->indexSlots != NULL) {
+        return;
+    }
+
+    build_chained_index(dictList, word_key, word_matches, &meta->indexSlots,
+            &meta->indexSize, &meta->indexNext);
+}
+
+/*
+ * Finds the first word in a dictionary equal (ignoring case) to a pattern
+ * of only letters, using the dictionary's hash index. Any later equal words
+ * are chained from it through indexNext.
+ * Returns the dictList index of the word, or -1 if there is none.
+ */
+int index_lookup(const char *pattern, WordList *dictList) {
+    WordMeta *meta = dictList->meta;
+    unsigned int slot = find_chain_slot(pattern, hash_word(pattern),
+            word_matches, meta->indexSlots, meta->indexSize, dictList);
+
+    return meta->indexSlots[slot];
+}
+
+/*
+ * Finds every all-letter word in a dictionary equal (ignoring case) to a
+ * pattern of only letters, using the dictionary's hash index.
+ * Returns a mask (bool arr) of the dictList indices of matching words.
+ */
+bool *index_match(char *pattern, WordList *dictList) {
+    bool *wordFlags = (bool *) calloc(dictList->numWords, sizeof(bool));
+    if (wordFlags == NULL) {
+        return NULL;
+    }
+
+    for (int word = index_lookup(pattern, dictList); word != -1;
+            word = dictList->meta->indexNext[word]) {
+        wordFlags[word] = true;
+    }
+
+    return wordFlags;
+}
+
+/*
+ * Checks if a word is in a dictionary (ignoring case) using the
+ * dictionary's hash index. Words containing non-letters are never found.
+ */
+bool index_contains(const char *word, WordList *dictList) {
+    for (int i = 0; word[i] != '\0'; ++i) {
+        if (!isalpha((unsigned char) word[i])) {
+            return false;
+        }
+    }
+
+    return index_lookup(word, dictList) != -1;
+}
@@ -0,0 +1,26 @@
+#ifndef WORDINDEX_H
+#define WORDINDEX_H
+
+#include <stdbool.h>
+#include <ctype.h>
+#include "wordList.h"
+
+// Starting value of a word hash (32 bit FNV-1a offset basis)
+#define HASH_SEED 2166136261u
+
+/*
+ * Adds a character to a case-insensitive FNV-1a word hash.
+ * Inline so the dictionary reader can hash words as it copies them.
+ */
+static inline unsigned int hash_step(unsigned int hash, char letter) {
+    return (hash ^ (unsigned char) tolower((unsigned char) letter)) \
+            * 16777619u;
+}
+
+unsigned int hash_word(const char *word);
+void build_word_index(WordList *dictList);
+int index_lookup(const char *pattern, WordList *dictList);
+bool *index_match(char *pattern, WordList *dictList);
+bool index_contains(const char *word, WordList *dictList);
+
+#endif //WORDINDEX_H
@@ -4,10 +4,14 @@
 #include "wordList.h"
 
 /*
- *  Returns a boolean array of all True values
+ *  Returns a boolean array of all True values, or NULL if it can't be
+ *  allocated
  */
 bool *fill_bool(int length) {
     bool *result = (bool *) malloc(length * sizeof(bool));
+    if (result == NULL) {
+        return NULL;
+    }
 
     // Set every value in the bool array to true
     for (int i = 0; i < length; i++) {
@@ -56,6 +60,7 @@ WordList *string_bool_mask(const bool *mask, WordList *listOfWords) {
     WordList *output = malloc(sizeof(WordList));
     output->words = outputWords;
     output->numWords = totalTrue;
+    output->meta = NULL;
 
     return output;
 
@@ -71,6 +76,20 @@ void free_wordlist(WordList *listOfWords) {
         free(listOfWords->words[i]);
     }
     free(listOfWords->words);
+
+    // Free per-word metadata if the WordList has any
+    if (listOfWords->meta != NULL) {
+        free(listOfWords->meta->lengths);
+        free(listOfWords->meta->isAlpha);
+        free(listOfWords->meta->hashes);
+        free(listOfWords->meta->lengthCounts);
+        free(listOfWords->meta->indexSlots);
+        free(listOfWords->meta->indexNext);
+        free(listOfWords->meta->signatures);
+        free(listOfWords->meta->signatureSlots);
+        free(listOfWords->meta->signatureNext);
+        free(listOfWords->meta);
+    }
     free(listOfWords);
 }
 
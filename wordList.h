@@ -3,6 +3,48 @@
 
 #include <stdbool.h>
 
+/* Per-word metadata computed while a dictionary is loaded.
+ *
+ * Each array is indexed the same as the words of the WordList owning it:
+ * lengths: strlen of each word
+ * isAlpha: true if the word contains only letters (i.e. it can be matched)
+ * hashes: case-insensitive hash of each word (see hash_word in wordIndex.c)
+ *
+ * Along with statistics about the whole dictionary:
+ * lengthCounts: number of all-letter words of each length, 0 to maxLength
+ * maxLength: length of the longest all-letter word (-1 if there are none)
+ *
+ * And a hash index of the all-letter words, made by build_word_index:
+ * indexSlots: open addressing table holding the index of the first word
+ *             of each distinct (ignoring case) word, -1 for empty slots.
+ *             NULL until the index has been built
+ * indexSize: number of slots in indexSlots (a power of 2)
+ * indexNext: index of the next word equal to each word ignoring case
+ *            (-1 if there are no more)
+ *
+ * And an index of the all-letter words by their letters, made by
+ * build_signature_index (all NULL until then):
+ * signatures: letter counts of each word, SIGNATURE_SIZE bytes per word
+ * signatureSlots/signatureSize/signatureNext: as for indexSlots, indexSize
+ *                                             and indexNext, but for words
+ *                                             with the same letter counts
+ *                                             (i.e. anagrams)
+ */
+typedef struct {
+    int *lengths;
+    bool *isAlpha;
+    unsigned int *hashes;
+    int *lengthCounts;
+    int maxLength;
+    int *indexSlots;
+    unsigned int indexSize;
+    int *indexNext;
+    unsigned char *signatures;
+    int *signatureSlots;
+    unsigned int signatureSize;
+    int *signatureNext;
+} WordMeta;
+
 /* Struct used to store a list of words.
  *
  * Contains an array of strings and an integer equal to the
@@ -11,10 +53,14 @@
  * Used for functions which operate on string arrays where it is useful to
  * also know the number of strings in the array.
  * (i.e. the exact/prefix/anywhere search functions in searchMethods.c)
+ *
+ * meta is only set for dictionaries read by file_to_wordlist, it is NULL for
+ * every other WordList (e.g. search output).
  */
 typedef struct {
     char **words;
     int numWords;
+    WordMeta *meta;
 } WordList;
 
 bool *fill_bool(int length);